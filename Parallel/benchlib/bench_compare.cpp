@@ -0,0 +1,38 @@
+#include <cstdio>
+#include <cstdlib>
+#include "benchlib.h"
+
+// 对比两份 BENCH_JSON 输出：中位数之比，以及两边置信区间是否分开
+// 用法: ./bench_compare <旧.json> <新.json> [容忍的变慢比例=0.02]
+// 有超出容忍度且显著变慢的项时返回 1，方便在脚本里做回归检查
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        fprintf(stderr, "usage: %s <base.json> <new.json> [tolerance]\n", argv[0]);
+        return 2;
+    }
+    auto base = benchlib::read_json(argv[1]);
+    auto next = benchlib::read_json(argv[2]);
+    double tolerance = argc > 3 ? atof(argv[3]) : 0.02;
+    int regressions = 0;
+    printf("%-32s %14s %14s %8s  %s\n", "name", "base ms", "new ms", "ratio", "verdict");
+    for (auto const &r: next) {
+        benchlib::Result const *b = nullptr;
+        for (auto const &x: base)
+            if (x.name == r.name)
+                b = &x;
+        if (!b) {
+            printf("%-32s %14s %14.4f %8s  new\n", r.name.c_str(), "-", r.ms(), "-");
+            continue;
+        }
+        double ratio = r.median / b->median;
+        char const *verdict = "~";
+        if (r.ci_low > b->ci_high) {
+            verdict = ratio > 1 + tolerance ? "SLOWER" : "slower";
+            regressions += ratio > 1 + tolerance;
+        } else if (r.ci_high < b->ci_low) {
+            verdict = "faster";
+        }
+        printf("%-32s %14.4f %14.4f %8.3f  %s\n", r.name.c_str(), b->ms(), r.ms(), ratio, verdict);
+    }
+    return regressions ? 1 : 0;
+}
@@ -0,0 +1,290 @@
+#include "benchlib.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <thread>
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+namespace benchlib {
+
+namespace {
+
+struct Registry {
+    std::vector<Result> results;
+
+    // 程序退出时按 BENCH_JSON 写出全部结果
+    ~Registry() {
+        char const *path = std::getenv("BENCH_JSON");
+        if (!path || results.empty())
+            return;
+        std::ofstream out(path);
+        write_json(out, results);
+        if (!out)
+            fprintf(stderr, "benchlib: cannot write %s\n", path);
+    }
+};
+
+Registry &registry() {
+    static Registry reg;
+    return reg;
+}
+
+template <class T>
+void env_override(char const *name, T &value) {
+    if (char const *s = std::getenv(name); s && *s)
+        value = (T)std::strtod(s, nullptr);
+}
+
+// 线性插值的分位数，sorted 必须非空且已排序
+double quantile(std::vector<double> const &sorted, double q) {
+    double pos = q * (sorted.size() - 1);
+    size_t i = (size_t)pos;
+    if (i + 1 >= sorted.size())
+        return sorted.back();
+    return sorted[i] + (pos - i) * (sorted[i + 1] - sorted[i]);
+}
+
+std::string format_time(double ns) {
+    char buf[32];
+    if (ns < 1e3)
+        snprintf(buf, sizeof buf, "%.1f ns", ns);
+    else if (ns < 1e6)
+        snprintf(buf, sizeof buf, "%.3f us", ns * 1e-3);
+    else if (ns < 1e9)
+        snprintf(buf, sizeof buf, "%.3f ms", ns * 1e-6);
+    else
+        snprintf(buf, sizeof buf, "%.3f s", ns * 1e-9);
+    return buf;
+}
+
+std::string escape(std::string const &s) {
+    std::string out;
+    for (char c: s) {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+// 在一行里找 "key": 后面的数值，找不到返回 NAN
+double field(std::string const &line, char const *key) {
+    std::string pat = std::string("\"") + key + "\":";
+    size_t p = line.find(pat);
+    if (p == std::string::npos)
+        return NAN;
+    return std::strtod(line.c_str() + p + pat.size(), nullptr);
+}
+
+}
+
+Options Options::from_env() {
+    Options opt;
+    env_override("BENCH_WARMUP", opt.warmup);
+    env_override("BENCH_MIN_RUNS", opt.min_runs);
+    env_override("BENCH_MAX_RUNS", opt.max_runs);
+    env_override("BENCH_MAX_SECONDS", opt.max_seconds);
+    env_override("BENCH_CI", opt.rel_ci);
+    env_override("BENCH_CPU", opt.cpu);
+    return opt;
+}
+
+Result summarize(std::string name, std::vector<double> samples) {
+    Result r;
+    r.name = std::move(name);
+    r.samples = std::move(samples);
+    size_t n = r.samples.size();
+    if (n == 0)
+        return r;
+    std::vector<double> sorted = r.samples;
+    std::sort(sorted.begin(), sorted.end());
+    r.min = sorted.front();
+    r.max = sorted.back();
+    r.median = quantile(sorted, 0.5);
+    r.p95 = quantile(sorted, 0.95);
+    double sum = 0;
+    for (double x: sorted)
+        sum += x;
+    r.mean = sum / n;
+    std::vector<double> dev(n);
+    for (size_t i = 0; i < n; i++)
+        dev[i] = std::abs(sorted[i] - r.median);
+    std::sort(dev.begin(), dev.end());
+    r.mad = quantile(dev, 0.5);
+    // 中位数的置信区间：秩 (n -/+ 1.96 sqrt(n)) / 2 处的次序统计量
+    double half = 1.96 * std::sqrt((double)n) / 2;
+    long lo = (long)std::floor(n / 2.0 - half) - 1;
+    long hi = (long)std::ceil(n / 2.0 + half) - 1;
+    r.ci_low = sorted[std::clamp(lo, 0l, (long)n - 1)];
+    r.ci_high = sorted[std::clamp(hi, 0l, (long)n - 1)];
+    return r;
+}
+
+Result run(std::string const &name, std::function<void()> const &body,
+           std::function<void()> const &setup, Options const &opt) {
+#ifdef __linux__
+    cpu_set_t saved;
+    bool pinned = opt.cpu >= 0 && sched_getaffinity(0, sizeof saved, &saved) == 0 &&
+                  pin_thread(opt.cpu);
+#endif
+    for (unsigned i = 0; i < opt.warmup; i++) {
+        if (setup)
+            setup();
+        body();
+    }
+    std::vector<double> samples;
+    double total = 0;
+    Result r;
+    std::unique_ptr<PerfCounters> counters;
+    if (perf_enabled())
+        counters = std::make_unique<PerfCounters>();
+    for (;;) {
+        if (setup)
+            setup();
+        if (counters)
+            counters->start();
+        clobber_memory();
+        auto t0 = std::chrono::steady_clock::now();
+        body();
+        clobber_memory();
+        auto t1 = std::chrono::steady_clock::now();
+        if (counters)
+            counters->stop();
+        double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        samples.push_back(ns);
+        total += ns;
+        if (samples.size() < opt.min_runs)
+            continue;
+        r = summarize(name, samples);
+        if (r.rel_ci() <= opt.rel_ci || samples.size() >= opt.max_runs ||
+            total >= opt.max_seconds * 1e9)
+            break;
+    }
+#ifdef __linux__
+    if (pinned)
+        sched_setaffinity(0, sizeof saved, &saved);
+#endif
+    if (counters) {
+        PerfCounts c = counters->read();
+        perf_record(name, c, r.runs());
+        for (int e = 0; e < kNumPerfEvents; e++)
+            c.value[e] /= r.runs();
+        r.counters = c;
+    }
+    registry().results.push_back(r);
+    return r;
+}
+
+bool pin_thread(unsigned cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu % cpu_count(), &set);
+    return sched_setaffinity(0, sizeof set, &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+unsigned cpu_count() {
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void print(Result const &r) {
+    printf("%-32s %12s  ±%5.2f%%  p95 %12s  MAD %12s  n=%zu\n", r.name.c_str(),
+           format_time(r.median).c_str(), r.rel_ci() * 100, format_time(r.p95).c_str(),
+           format_time(r.mad).c_str(), r.runs());
+}
+
+std::vector<Result> const &results() {
+    return registry().results;
+}
+
+// 每个结果占一行，read_json 按行解析
+void write_json(std::ostream &out, std::vector<Result> const &results) {
+    char host[256] = "unknown";
+#ifdef __linux__
+    gethostname(host, sizeof host - 1);
+#endif
+    out << "{\n\"host\": \"" << escape(host) << "\",\n\"cpus\": " << cpu_count()
+        << ",\n\"compiler\": \"" << escape(__VERSION__) << "\",\n\"results\": [\n";
+    char buf[256];
+    for (size_t i = 0; i < results.size(); i++) {
+        auto const &r = results[i];
+        out << "{\"name\": \"" << escape(r.name) << "\", \"runs\": " << r.runs();
+        snprintf(buf, sizeof buf,
+                 ", \"median_ns\": %.1f, \"p95_ns\": %.1f, \"mad_ns\": %.1f, \"mean_ns\": %.1f"
+                 ", \"min_ns\": %.1f, \"max_ns\": %.1f, \"ci_low_ns\": %.1f, \"ci_high_ns\": %.1f",
+                 r.median, r.p95, r.mad, r.mean, r.min, r.max, r.ci_low, r.ci_high);
+        out << buf;
+        for (int e = 0; e < kNumPerfEvents; e++) {
+            if (r.counters.valid[e]) {
+                snprintf(buf, sizeof buf, ", \"perf_%s\": %.6g", perf_event_name((PerfEvent)e),
+                         r.counters.value[e]);
+                out << buf;
+            }
+        }
+        out << ", \"samples_ns\": [";
+        for (size_t k = 0; k < r.samples.size(); k++) {
+            snprintf(buf, sizeof buf, "%s%.1f", k ? ", " : "", r.samples[k]);
+            out << buf;
+        }
+        out << "]}" << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "]\n}\n";
+}
+
+bool write_json(std::string const &path) {
+    std::ofstream out(path);
+    if (!out)
+        return false;
+    write_json(out, registry().results);
+    return (bool)out;
+}
+
+std::vector<Result> read_json(std::string const &path) {
+    std::vector<Result> out;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t p = line.find("{\"name\": \"");
+        if (p == std::string::npos)
+            continue;
+        Result r;
+        for (p += 10; p < line.size() && line[p] != '"'; p++) {
+            if (line[p] == '\\')
+                p++;
+            r.name += line[p];
+        }
+        size_t s = line.find("\"samples_ns\": [");
+        if (s != std::string::npos) {
+            char const *c = line.c_str() + s + 15;
+            char *end;
+            for (double x = std::strtod(c, &end); end != c; x = std::strtod(c, &end)) {
+                r.samples.push_back(x);
+                c = end;
+                while (*c == ',' || *c == ' ')
+                    c++;
+            }
+        }
+        if (!r.samples.empty()) {
+            r = summarize(r.name, r.samples);
+        } else {
+            r.median = field(line, "median_ns");
+            r.ci_low = field(line, "ci_low_ns");
+            r.ci_high = field(line, "ci_high_ns");
+        }
+        out.push_back(std::move(r));
+    }
+    return out;
+}
+
+}
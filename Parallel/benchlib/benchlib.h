@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include "perf.h"
+
+// 各次作业共用的计时库：预热、重复到中位数的置信区间足够窄为止，
+// 报告 ns 级的中位数 / p95 / MAD，并可导出 JSON 供 bench_compare 对比
+namespace benchlib {
+
+// 让编译器认为 value 被读过，避免计算结果被当成死代码删掉
+template <class T>
+inline void do_not_optimize(T const &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// 让编译器认为所有内存都可能被读写过
+inline void clobber_memory() {
+    asm volatile("" : : : "memory");
+}
+
+struct Options {
+    unsigned warmup = 1;      // 不计入统计的预热次数
+    unsigned min_runs = 5;
+    unsigned max_runs = 200;
+    double max_seconds = 10;  // 计时部分的总预算，超出后即使区间没收敛也停下
+    double rel_ci = 0.01;     // 目标：中位数 95% 置信区间的半宽 / 中位数
+    int cpu = -1;             // >= 0 时测量期间把调用线程绑到这个核上
+
+    // 默认值可以被环境变量覆盖：
+    // BENCH_WARMUP BENCH_MIN_RUNS BENCH_MAX_RUNS BENCH_MAX_SECONDS BENCH_CI BENCH_CPU
+    static Options from_env();
+};
+
+struct Result {
+    std::string name;
+    std::vector<double> samples;  // 每次用时 (ns)，按测量顺序
+    double median = 0, p95 = 0, mad = 0, mean = 0, min = 0, max = 0;
+    double ci_low = 0, ci_high = 0;  // 中位数的 95% 置信区间，由次序统计量给出，不假设正态
+    PerfCounts counters;             // BENCH_PERF=1 时每次运行的平均硬件计数
+
+    size_t runs() const noexcept {
+        return samples.size();
+    }
+    double ms() const noexcept {
+        return median * 1e-6;
+    }
+    // 置信区间半宽相对中位数的比例
+    double rel_ci() const noexcept {
+        return median > 0 ? (ci_high - ci_low) / 2 / median : 0;
+    }
+};
+
+// 由一组样本算出统计量
+Result summarize(std::string name, std::vector<double> samples);
+
+// 反复执行 body 并计时；setup 在每次计时之前执行，不计入用时，用来把状态恢复到初值
+// 结果同时记入全局报告，设置了 BENCH_JSON=<路径> 时程序退出前会写出
+Result run(std::string const &name, std::function<void()> const &body,
+           std::function<void()> const &setup = {}, Options const &opt = Options::from_env());
+
+// 把当前线程绑到指定核上，不支持或失败时返回 false
+bool pin_thread(unsigned cpu);
+unsigned cpu_count();
+
+// 一行人类可读的摘要：中位数 ±CI  p95  MAD  次数
+void print(Result const &r);
+
+// 全局报告：所有 run() 的结果
+std::vector<Result> const &results();
+void write_json(std::ostream &out, std::vector<Result> const &results);
+bool write_json(std::string const &path);
+
+// 读回 write_json 写出的文件，只解析本库自己的格式
+std::vector<Result> read_json(std::string const &path);
+
+}
@@ -0,0 +1,273 @@
+#include "perf.h"
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <utility>
+#ifdef __linux__
+#include <dirent.h>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace benchlib {
+
+namespace {
+
+struct PerfTable {
+    std::vector<std::pair<std::string, std::pair<PerfCounts, size_t>>> rows;
+
+    // 程序退出时打印
+    ~PerfTable() {
+        if (!rows.empty())
+            print_perf_table(stdout);
+    }
+};
+
+PerfTable &perf_table() {
+    static PerfTable table;
+    return table;
+}
+
+#ifdef __linux__
+bool is_intel() {
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(in, line))
+        if (line.compare(0, 9, "vendor_id") == 0)
+            return line.find("GenuineIntel") != std::string::npos;
+    return false;
+}
+
+// 返回 false 表示这台机器上没有对应的事件
+bool event_attr(PerfEvent e, perf_event_attr &attr) {
+    memset(&attr, 0, sizeof attr);
+    attr.size = sizeof attr;
+    auto cache = [](uint64_t level) {
+        return level | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    };
+    // FP_ARITH_INST_RETIRED (0xC7)：umask 低两位是标量，其余是 128/256/512 位打包
+    static bool const intel = is_intel();
+    char const *raw = nullptr;
+    switch (e) {
+    case kCycles: attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+    case kInstructions: attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+    case kL1dMisses: attr.type = PERF_TYPE_HW_CACHE; attr.config = cache(PERF_COUNT_HW_CACHE_L1D); break;
+    case kLlcMisses: attr.type = PERF_TYPE_HW_CACHE; attr.config = cache(PERF_COUNT_HW_CACHE_LL); break;
+    case kBranchMisses: attr.type = PERF_TYPE_HARDWARE; attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+    case kFpScalar:
+        raw = std::getenv("BENCH_PERF_FP_SCALAR");
+        attr.type = PERF_TYPE_RAW;
+        attr.config = raw ? std::strtoull(raw, nullptr, 16) : 0x03c7;
+        if (!raw && !intel)
+            return false;
+        break;
+    case kFpPacked:
+        raw = std::getenv("BENCH_PERF_FP_PACKED");
+        attr.type = PERF_TYPE_RAW;
+        attr.config = raw ? std::strtoull(raw, nullptr, 16) : 0xfcc7;
+        if (!raw && !intel)
+            return false;
+        break;
+    case kTaskClock: attr.type = PERF_TYPE_SOFTWARE; attr.config = PERF_COUNT_SW_TASK_CLOCK; break;
+    case kPageFaults: attr.type = PERF_TYPE_SOFTWARE; attr.config = PERF_COUNT_SW_PAGE_FAULTS; break;
+    case kContextSwitches: attr.type = PERF_TYPE_SOFTWARE; attr.config = PERF_COUNT_SW_CONTEXT_SWITCHES; break;
+    default: return false;
+    }
+    attr.disabled = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return true;
+}
+
+int open_event(perf_event_attr &attr, pid_t tid) {
+    // perf_event_paranoid >= 2 时不允许统计内核态，退回只统计用户态
+    attr.exclude_kernel = 0;
+    int fd = syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0);
+    if (fd < 0 && (errno == EACCES || errno == EPERM)) {
+        attr.exclude_kernel = 1;
+        fd = syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0);
+    }
+    return fd;
+}
+
+std::vector<pid_t> list_threads() {
+    std::vector<pid_t> tids;
+    if (DIR *dir = opendir("/proc/self/task")) {
+        while (dirent *ent = readdir(dir))
+            if (ent->d_name[0] != '.')
+                tids.push_back(atoi(ent->d_name));
+        closedir(dir);
+    }
+    if (tids.empty())
+        tids.push_back(0);
+    return tids;
+}
+#endif
+
+}
+
+char const *perf_event_name(PerfEvent e) {
+    static char const *const names[kNumPerfEvents] = {
+        "cycles", "instructions", "L1D-miss", "LLC-miss", "br-miss",
+        "fp-scalar", "fp-packed", "task-ms", "page-faults", "ctx-switch",
+    };
+    return e < kNumPerfEvents ? names[e] : "?";
+}
+
+PerfCounts &PerfCounts::operator+=(PerfCounts const &o) {
+    for (int e = 0; e < kNumPerfEvents; e++) {
+        value[e] += o.value[e];
+        valid[e] = valid[e] || o.valid[e];
+    }
+    return *this;
+}
+
+double PerfCounts::ipc() const {
+    if (!valid[kCycles] || !valid[kInstructions] || value[kCycles] == 0)
+        return 0;
+    return value[kInstructions] / value[kCycles];
+}
+
+PerfCounters::PerfCounters() {
+#ifdef __linux__
+    auto tids = list_threads();
+    for (int e = 0; e < kNumPerfEvents; e++) {
+        perf_event_attr attr;
+        if (!event_attr((PerfEvent)e, attr))
+            continue;
+        for (pid_t tid: tids) {
+            int fd = open_event(attr, tid);
+            if (fd < 0)
+                break;  // 一个线程打不开，其他线程多半也打不开
+            m_fds.push_back({fd, (PerfEvent)e});
+        }
+    }
+#endif
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (auto const &f: m_fds)
+        close(f.fd);
+#endif
+}
+
+void PerfCounters::start() {
+#ifdef __linux__
+    for (auto const &f: m_fds)
+        ioctl(f.fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+}
+
+void PerfCounters::stop() {
+#ifdef __linux__
+    for (auto const &f: m_fds)
+        ioctl(f.fd, PERF_EVENT_IOC_DISABLE, 0);
+#endif
+}
+
+PerfCounts PerfCounters::read() const {
+    PerfCounts c;
+#ifdef __linux__
+    for (auto const &f: m_fds) {
+        uint64_t buf[3];  // value, time_enabled, time_running
+        if (::read(f.fd, buf, sizeof buf) != sizeof buf || buf[2] == 0)
+            continue;
+        c.value[f.event] += (double)buf[0] * buf[1] / buf[2];
+        c.valid[f.event] = true;
+    }
+    if (c.valid[kTaskClock])
+        c.value[kTaskClock] *= 1e-6;  // ns -> ms
+#endif
+    return c;
+}
+
+bool perf_enabled() {
+    static bool const enabled = [] {
+        char const *s = std::getenv("BENCH_PERF");
+        return s && *s && strcmp(s, "0") != 0;
+    }();
+    return enabled;
+}
+
+void perf_record(std::string const &name, PerfCounts const &counts, size_t calls) {
+    auto &rows = perf_table().rows;
+    for (auto &row: rows) {
+        if (row.first == name) {
+            row.second.first += counts;
+            row.second.second += calls;
+            return;
+        }
+    }
+    rows.push_back({name, {counts, calls}});
+}
+
+void print_perf_table(FILE *out) {
+    auto const &rows = perf_table().rows;
+    bool any[kNumPerfEvents] = {};
+    for (auto const &row: rows)
+        for (int e = 0; e < kNumPerfEvents; e++)
+            any[e] = any[e] || row.second.first.valid[e];
+    fprintf(out, "\nperf counters (per call)\n%-32s %6s", "region", "calls");
+    for (int e = 0; e < kNumPerfEvents; e++)
+        if (any[e])
+            fprintf(out, " %12s", perf_event_name((PerfEvent)e));
+    bool ipc = any[kCycles] && any[kInstructions];
+    bool mpki = any[kInstructions] && (any[kL1dMisses] || any[kLlcMisses]);
+    bool simd = any[kFpScalar] && any[kFpPacked];
+    if (ipc)
+        fprintf(out, " %6s", "IPC");
+    if (mpki)
+        fprintf(out, " %9s %9s", "L1D/ki", "LLC/ki");
+    if (simd)
+        fprintf(out, " %7s", "packed%");
+    fprintf(out, "\n");
+    for (auto const &[name, entry]: rows) {
+        auto const &[c, calls] = entry;
+        fprintf(out, "%-32s %6zu", name.c_str(), calls);
+        for (int e = 0; e < kNumPerfEvents; e++) {
+            if (!any[e])
+                continue;
+            if (c.valid[e])
+                fprintf(out, " %12.4g", c.value[e] / calls);
+            else
+                fprintf(out, " %12s", "-");
+        }
+        double ki = c.value[kInstructions] * 1e-3;
+        if (ipc)
+            fprintf(out, " %6.2f", c.ipc());
+        if (mpki)
+            fprintf(out, " %9.3f %9.3f", ki ? c.value[kL1dMisses] / ki : 0, ki ? c.value[kLlcMisses] / ki : 0);
+        if (simd) {
+            double fp = c.value[kFpScalar] + c.value[kFpPacked];
+            fprintf(out, " %7.1f", fp ? c.value[kFpPacked] / fp * 100 : 0);
+        }
+        fprintf(out, "\n");
+    }
+    std::string missing;
+    for (int e = 0; e < kNumPerfEvents; e++)
+        if (!any[e])
+            missing += std::string(" ") + perf_event_name((PerfEvent)e);
+    if (!missing.empty())
+        fprintf(out, "unavailable on this machine:%s\n", missing.c_str());
+}
+
+PerfScope::PerfScope(std::string name) : m_name(std::move(name)) {
+    if (perf_enabled()) {
+        m_counters = std::make_unique<PerfCounters>();
+        m_counters->start();
+    }
+}
+
+PerfScope::~PerfScope() {
+    if (m_counters) {
+        m_counters->stop();
+        perf_record(m_name, m_counters->read());
+    }
+}
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+// 基于 perf_event_open 的硬件计数器：周期、指令、L1D / LLC 读缺失、分支预测失败、
+// 标量 / 打包浮点指令（只在 Intel 上有对应事件），外加几个软件事件
+// 设置 BENCH_PERF=1 时启用；内核不允许、虚拟机没有 PMU、非 Linux 时对应的列显示为 "-"，不影响计时
+namespace benchlib {
+
+enum PerfEvent {
+    kCycles,
+    kInstructions,
+    kL1dMisses,
+    kLlcMisses,
+    kBranchMisses,
+    kFpScalar,
+    kFpPacked,
+    kTaskClock,
+    kPageFaults,
+    kContextSwitches,
+    kNumPerfEvents,
+};
+
+char const *perf_event_name(PerfEvent e);
+
+struct PerfCounts {
+    double value[kNumPerfEvents] = {};
+    bool valid[kNumPerfEvents] = {};
+
+    PerfCounts &operator+=(PerfCounts const &o);
+    double ipc() const;
+};
+
+// 打开时对当前进程里已有的每个线程各开一组计数器，所以线程池里的工作线程也算在内
+// 每个事件单独打开而不是成组，事件多于 PMU 寄存器时由内核轮换，读数按运行时间比例放大
+class PerfCounters {
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(PerfCounters const &) = delete;
+    PerfCounters &operator=(PerfCounters const &) = delete;
+
+    // 至少有一个事件打开成功
+    bool available() const noexcept {
+        return !m_fds.empty();
+    }
+
+    void start();
+    void stop();
+    // 自构造以来所有 start/stop 区间的累计值
+    PerfCounts read() const;
+
+private:
+    struct Fd {
+        int fd;
+        PerfEvent event;
+    };
+    std::vector<Fd> m_fds;
+};
+
+// 是否设置了 BENCH_PERF
+bool perf_enabled();
+
+// 把一段计数按区域名累计进全局表；benchlib::run 会自动按 benchmark 的名字记录
+void perf_record(std::string const &name, PerfCounts const &counts, size_t calls = 1);
+
+// 按区域打印计数表：每次调用的平均值，以及 IPC、每千条指令的缺失数、浮点指令的打包比例
+void print_perf_table(FILE *out = stdout);
+
+// 作用域内的计数记到 name 下，BENCH_PERF 没设置时什么也不做
+class PerfScope {
+public:
+    explicit PerfScope(std::string name);
+    ~PerfScope();
+
+    PerfScope(PerfScope const &) = delete;
+    PerfScope &operator=(PerfScope const &) = delete;
+
+private:
+    std::string m_name;
+    std::unique_ptr<PerfCounters> m_counters;
+};
+
+}
@@ -0,0 +1,63 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include "nbody.h"
+#include "blockstep.h"
+#include "integrator.h"
+#include "benchmark.h"
+
+// 成团的初始条件：大部分粒子均匀分布，一小撮挤在一个小球里
+static Bodies clustered(size_t n, float frac, float radius) {
+    Bodies b = make_bodies(n);
+    for (size_t i = 0; i < n * frac; i++) {
+        b.px[i] *= radius;
+        b.py[i] *= radius;
+        b.pz[i] *= radius;
+    }
+    return b;
+}
+
+// 每单位模拟时间的力计算次数：块时间步 vs 全体都用最细一级的全局步长
+// 用法: ./bench_blockstep [N] [T] [dt_max] [eta]
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? atol(argv[1]) : 1024;
+    float t_end = argc > 2 ? atof(argv[2]) : 1;
+    float dt_max = argc > 3 ? atof(argv[3]) : 0.04f;
+    float eta = argc > 4 ? atof(argv[4]) : 0.005f;
+    Bodies init_state = clustered(n, 0.1f, 0.02f);
+    double e0 = energy(init_state);
+    long steps = std::lround(t_end / dt_max);
+
+    Bodies b;
+    WorkStealingPool pool(1);
+    std::unique_ptr<BlockStepper> block;
+    auto r = benchmark("blockstep/block", [&] {
+        b = init_state;
+        block = std::make_unique<BlockStepper>(pool, dt_max, 12, eta);
+    }, [&] {
+        block->begin(b);
+        for (long s = 0; s < steps; s++)
+            block->step(b);
+        block->finish(b);
+    });
+    printf("block:  %.3f ms, %.4g evals/time, |dE|=%.3e\n",
+           r.ms(), block->force_evaluations() / t_end, std::fabs(energy(b) - e0));
+    auto hist = block->level_histogram();
+    for (size_t l = 0; l < hist.size(); l++)
+        if (hist[l])
+            printf("  level %2zu (dt=%g): %zu bodies\n", l, std::ldexp(dt_max, -(int)l), hist[l]);
+
+    float h = std::ldexp(dt_max, -block->deepest_level());
+    long fine_steps = std::lround(t_end / h);
+    r = benchmark("blockstep/global", [&] { b = init_state; }, [&](WorkStealingPool &pool) {
+        FusedIntegrator integ(leapfrog(), pool);
+        integ.begin(b, h);
+        for (long s = 0; s < fine_steps; s++)
+            integ.step(b, h);
+        integ.finish(b, h);
+    }, 1);
+    printf("global: %.3f ms, %.4g evals/time, |dE|=%.3e (dt=%g)\n",
+           r.ms(), (double)n * fine_steps / t_end, std::fabs(energy(b) - e0), h);
+    return 0;
+}
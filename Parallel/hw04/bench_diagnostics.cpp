@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "nbody.h"
+#include "parallel.h"
+#include "benchmark.h"
+
+// 单独一遍的并行统计，作为融合统计的对照：和 step(b, &diag) 同样的 float 成对势能，
+// 也只算 j > i 的一半，区别只在于要把粒子数据再从头读一遍
+static Diagnostics measure(WorkStealingPool &pool, Bodies const &b) {
+    constexpr size_t grain = 64;
+    size_t n = b.size();
+    float const *px = b.px.data(), *py = b.py.data(), *pz = b.pz.data();
+    float const *m = b.mass.data();
+    PlummerLaw const law(eps);
+    std::vector<Diagnostics> part((n + grain - 1) / grain);
+    pool.parallel_for(n, grain, [&](size_t begin, size_t end, unsigned) {
+        Diagnostics d;
+        for (size_t i = begin; i < end; i++) {
+            float xi = px[i], yi = py[i], zi = pz[i];
+            float sp = 0;
+#pragma omp simd reduction(+:sp)
+            for (size_t j = i + 1; j < n; j++) {
+                float dx = px[j] - xi;
+                float dy = py[j] - yi;
+                float dz = pz[j] - zi;
+                sp += m[j] * law.potential(dx * dx + dy * dy + dz * dz);
+            }
+            double mi = m[i];
+            double vx = b.vx[i], vy = b.vy[i], vz = b.vz[i];
+            d.potential -= G * mi * (sp + mi * law.potential(0) / 2);
+            d.kinetic += mi * (vx * vx + vy * vy + vz * vz) / 2;
+            d.momentum[0] += mi * vx;
+            d.momentum[1] += mi * vy;
+            d.momentum[2] += mi * vz;
+            d.angular[0] += mi * (yi * vz - zi * vy);
+            d.angular[1] += mi * (zi * vx - xi * vz);
+            d.angular[2] += mi * (xi * vy - yi * vx);
+        }
+        part[begin / grain] = d;
+    });
+    Diagnostics sum;
+    for (auto const &d: part) {
+        sum.kinetic += d.kinetic;
+        sum.potential += d.potential;
+        for (int a = 0; a < 3; a++) {
+            sum.momentum[a] += d.momentum[a];
+            sum.angular[a] += d.angular[a];
+        }
+    }
+    return sum;
+}
+
+// 每步都监控能量的代价：融合统计 vs 每步之前单独再跑一遍并行的 O(N^2) 统计
+// 用法: ./bench_diagnostics [N] [steps]
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? atol(argv[1]) : 4096;
+    int steps = argc > 2 ? atoi(argv[2]) : 20;
+    unsigned nthreads = std::max(1u, std::thread::hardware_concurrency());
+    Bodies init_state = make_bodies(n);
+
+    Bodies b;
+    auto reset = [&] { b = init_state; };
+    auto plain = benchmark("diagnostics/step", reset, [&](WorkStealingPool &pool) {
+        ParallelStepper stepper(pool);
+        for (int s = 0; s < steps; s++)
+            stepper.step(b);
+    }, nthreads);
+
+    Diagnostics sep;
+    auto separate = benchmark("diagnostics/step+measure", reset, [&](WorkStealingPool &pool) {
+        ParallelStepper stepper(pool);
+        for (int s = 0; s < steps; s++) {
+            sep = measure(pool, b);
+            stepper.step(b);
+        }
+    }, nthreads);
+
+    Diagnostics d;
+    auto fused = benchmark("diagnostics/step(diag)", reset, [&](WorkStealingPool &pool) {
+        ParallelStepper stepper(pool);
+        for (int s = 0; s < steps; s++)
+            stepper.step(b, &d);
+    }, nthreads);
+
+    printf("N=%zu steps=%d threads=%u\n", n, steps, nthreads);
+    for (auto const *r: {&plain, &separate, &fused})
+        benchlib::print(*r);
+    printf("last energy: fused %.9f, separate %.9f\n", d.energy(), sep.energy());
+    printf("momentum (%.3e, %.3e, %.3e) angular (%.3e, %.3e, %.3e)\n",
+           d.momentum[0], d.momentum[1], d.momentum[2],
+           d.angular[0], d.angular[1], d.angular[2]);
+
+    // 同一状态下换线程数，统计结果应逐位相同
+    for (unsigned t = 1; t <= nthreads; t *= 2) {
+        Bodies c = init_state;
+        Diagnostics diag;
+        WorkStealingPool pool(t);
+        ParallelStepper(pool).step(c, &diag);
+        printf("threads=%2u  E=%a  Lz=%a\n", t, diag.energy(), diag.angular[2]);
+    }
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include "nbody.h"
+#include "ensemble.h"
+#include "star_system.h"
+#include "benchmark.h"
+
+// M 个 48 体系统的参数扫描：逐个系统依次模拟 vs 跨系统 SIMD 的 Ensemble
+// 用法: ./bench_ensemble [M] [steps]
+int main(int argc, char **argv) {
+    size_t m = argc > 1 ? atol(argv[1]) : 1024;
+    long steps = argc > 2 ? atol(argv[2]) : 1000;
+    constexpr size_t n = 48;
+    unsigned nthreads = std::max(1u, std::thread::hardware_concurrency());
+    double body_steps = (double)m * n * steps;
+
+    Ensemble ens(m, n);
+    ens.init(1);
+    std::vector<StarSystem<n>> seq;
+    auto t_seq = benchmark("ensemble/one-by-one", [&] {
+        seq.clear();
+        for (size_t s = 0; s < m; s++)
+            seq.push_back(StarSystem<n>::from(ens.extract(s)));
+    }, [&] {
+        for (auto &sys: seq)
+            for (long k = 0; k < steps; k++)
+                sys.step();
+    });
+    printf("one by one (StarSystem<48>): %10.3f ms  %.3g body-steps/s\n",
+           t_seq.ms(), body_steps / t_seq.ms() * 1e3);
+
+    for (unsigned t = 1;; t = std::min(t * 2, nthreads)) {
+        Ensemble e = ens;
+        auto r = benchmark("ensemble/t=" + std::to_string(t), [&] { e = ens; }, [&](WorkStealingPool &pool) {
+            for (long k = 0; k < steps; k++)
+                e.step(pool);
+        }, t);
+        printf("ensemble, %2u threads:        %10.3f ms  %.3g body-steps/s\n",
+               t, r.ms(), body_steps / r.ms() * 1e3);
+        if (t == nthreads) {
+            // 抽查一个系统，和单独模拟的结果对比
+            Bodies a = e.extract(m / 2), b;
+            seq[m / 2].store(b);
+            float err = 0;
+            for (size_t i = 0; i < n; i++)
+                err = std::max(err, std::abs(a.px[i] - b.px[i]));
+            printf("max |dx| vs one-by-one on system %zu: %g\n", m / 2, err);
+            break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include <cstdio>
+#include <string>
+#include "nbody.h"
+#include "star_system.h"
+#include "integrator.h"
+#include "benchmark.h"
+
+// 编译期 N 的 StarSystem<N> 对比运行期 N 的 step() 和 SoA 的 FusedIntegrator
+template <size_t N>
+void run() {
+    Bodies init_state = make_bodies(N);
+    long steps = (1l << 27) / (N * N);
+
+    std::string tag = "/N=" + std::to_string(N);
+    auto t_aos = benchmark("fixed/step()" + tag, [&] { to_stars(init_state, stars); }, [&] {
+        for (long s = 0; s < steps; s++)
+            step();
+    });
+    float e_aos = calc();
+
+    Bodies b;
+    auto t_soa = benchmark("fixed/SoA" + tag, [&] { b = init_state; }, [&](WorkStealingPool &pool) {
+        FusedIntegrator integ(euler(), pool);
+        for (long s = 0; s < steps; s++)
+            integ.step(b, dt);
+    }, 1);
+    to_stars(b, stars);
+    float e_soa = calc();
+
+    StarSystem<N> sys;
+    auto t_fixed = benchmark("fixed/StarSystem" + tag, [&] { sys = StarSystem<N>::from(init_state); }, [&] {
+        for (long s = 0; s < steps; s++)
+            sys.step();
+    });
+
+    printf("%5zu %8ld %10.3f %10.3f %10.3f   %f %f %f\n", N, steps,
+           t_aos.ms(), t_soa.ms(), t_fixed.ms(), e_aos, e_soa, sys.calc());
+}
+
+int main() {
+    printf("%5s %8s %10s %10s %10s   %s\n", "N", "steps",
+           "step() ms", "SoA ms", "fixed ms", "final energy (step/SoA/fixed)");
+    run<16>();
+    run<48>();
+    run<256>();
+    return 0;
+}
@@ -0,0 +1,44 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include "nbody.h"
+#include "initial.h"
+#include "rng.h"
+#include "benchmark.h"
+
+// 所有字段按位做个哈希，用来检查不同线程数下的结果是否逐位一致
+static uint64_t digest(Bodies const &b) {
+    uint64_t h = 0;
+    for (auto const *f: {&b.px, &b.py, &b.pz, &b.vx, &b.vy, &b.vz, &b.mass}) {
+        for (float x: *f) {
+            uint32_t u;
+            memcpy(&u, &x, sizeof u);
+            h = splitmix64(h ^ u);
+        }
+    }
+    return h;
+}
+
+// 用法: ./bench_init [N]
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? atol(argv[1]) : 1000000;
+    unsigned nthreads = std::max(1u, std::thread::hardware_concurrency());
+    printf("%14s %8s %10s %18s\n", "distribution", "threads", "ms", "digest");
+    for (unsigned t = 1;; t = std::min(t * 2, nthreads)) {
+        Bodies b;
+        auto report = [&](char const *name, auto const &gen) {
+            auto r = benchmark(std::string("init/") + name + "/t=" + std::to_string(t), [] {},
+                               [&](WorkStealingPool &pool) { b = gen(pool); }, t);
+            printf("%14s %8u %10.3f %18llx\n", name, t, r.ms(), (unsigned long long)digest(b));
+        };
+        report("uniform_cube", [&](WorkStealingPool &pool) { return uniform_cube(n, 42, &pool); });
+        report("plummer", [&](WorkStealingPool &pool) { return plummer(n, 42, n, 1, &pool); });
+        report("disk", [&](WorkStealingPool &pool) { return disk(n, 42, n, 1, 0.01f, &pool); });
+        if (t == nthreads)
+            break;
+    }
+    return 0;
+}
@@ -0,0 +1,35 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "nbody.h"
+#include "integrator.h"
+#include "benchmark.h"
+
+// 达到同样能量误差所需的时间：每种积分器扫一遍 dt，积分到同一个终止时刻
+// 用法: ./bench_integrators [N] [T]
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? atol(argv[1]) : 48;
+    float t_end = argc > 2 ? atof(argv[2]) : 10;
+    Bodies init_state = make_bodies(n);
+    double e0 = energy(init_state);
+    printf("N=%zu T=%g E0=%.9f\n", n, t_end, e0);
+    printf("%10s %10s %8s %8s %10s %12s\n", "scheme", "dt", "steps", "forces", "ms", "|dE|");
+    for (auto const &scheme: {euler(), leapfrog(), yoshida4()}) {
+        for (float h = 0.04f; h >= 0.0025f; h /= 2) {
+            Bodies b;
+            long steps = std::lround(t_end / h);
+            auto r = benchmark(std::string("integrators/") + scheme.name + "/dt=" + std::to_string(h),
+                               [&] { b = init_state; }, [&](WorkStealingPool &pool) {
+                FusedIntegrator integ(scheme, pool);
+                integ.begin(b, h);
+                for (long s = 0; s < steps; s++)
+                    integ.step(b, h);
+                integ.finish(b, h);
+            }, 1);
+            printf("%10s %10g %8ld %8ld %10.3f %12.3e\n", scheme.name, h, steps,
+                   steps * (long)scheme.substeps.size(), r.ms(), std::fabs(energy(b) - e0));
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,39 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include "nbody.h"
+#include "parallel.h"
+#include "benchmark.h"
+
+template <class Law>
+void run(char const *name, Bodies const &init_state, int steps, unsigned nthreads) {
+    Bodies b;
+    Diagnostics d0, d1;
+    auto r = benchmark(std::string("laws/") + name, [&] { b = init_state; }, [&](WorkStealingPool &pool) {
+        BasicParallelStepper<Law> stepper(pool);
+        stepper.step(b, &d0);
+        for (int s = 1; s < steps; s++)
+            stepper.step(b);
+        stepper.step(b, &d1);
+    }, nthreads);
+    double pairs = (double)b.size() * (b.size() - 1) / 2 * (steps + 1);
+    printf("%10s %10.3f %7.2f %10.3f %14.6e\n", name, r.ms(), r.rel_ci() * 100,
+           pairs / r.ms() * 1e-6, d1.energy() - d0.energy());
+}
+
+// 每种力律在 N=8k 下的用时
+// 用法: ./bench_laws [N] [steps]
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? atol(argv[1]) : 8192;
+    int steps = argc > 2 ? atoi(argv[2]) : 10;
+    unsigned nthreads = std::max(1u, std::thread::hardware_concurrency());
+    Bodies init_state = make_bodies(n);
+    printf("N=%zu steps=%d threads=%u\n", n, steps, nthreads);
+    printf("%10s %10s %7s %10s %14s\n", "law", "ms", "±%", "Gpair/s", "dE");
+    run<PlummerLaw>("plummer", init_state, steps, nthreads);
+    run<SplineLaw>("spline", init_state, steps, nthreads);
+    run<CoulombLaw>("coulomb", init_state, steps, nthreads);
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "nbody.h"
+#include "mixed.h"
+#include "integrator.h"
+#include "benchmark.h"
+
+// 纯 float / 混合精度 / 全 double 三种 step 的吞吐和能量漂移，能量用 calc() 与 energy() 两种方式检查
+// 能量漂移分不出 double 累加和补偿累加，另外列出速度与全 double 结果的最大偏差
+// 用法: ./bench_mixed [N] [steps]
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? atol(argv[1]) : 48;
+    long steps = argc > 2 ? atol(argv[2]) : 20000;
+    Bodies init_state = make_bodies(n);
+    to_stars(init_state, stars);
+    float c0 = calc();
+    double e0 = energy(init_state);
+    printf("N=%zu steps=%ld E0: calc()=%f energy()=%.9f\n", n, steps, c0, e0);
+    printf("%12s %10s %12s %14s %12s\n", "mode", "ms", "calc() dE", "energy() dE", "max |dv|");
+
+    MixedBodies ref = MixedBodies::from(init_state);
+    for (long s = 0; s < steps; s++)
+        step_double(ref);
+    // 混合精度的结果在存回 float 之前比较，否则差别被 float 的舍入盖住
+    auto max_dv = [&](auto const &b) {
+        double dv = 0;
+        for (size_t i = 0; i < n; i++) {
+            dv = std::max(dv, std::abs(b.vx[i] - ref.vx[i]));
+            dv = std::max(dv, std::abs(b.vy[i] - ref.vy[i]));
+            dv = std::max(dv, std::abs(b.vz[i] - ref.vz[i]));
+        }
+        return dv;
+    };
+    auto report = [&](char const *name, benchlib::Result const &r, Bodies const &b, double dv) {
+        to_stars(b, stars);
+        printf("%12s %10.3f %12.3e %14.6e %12.3e\n", name, r.ms(), calc() - c0, energy(b) - e0, dv);
+    };
+
+    Bodies b;
+    auto r = benchmark("mixed/float", [&] { b = init_state; }, [&](WorkStealingPool &pool) {
+        FusedIntegrator integ(euler(), pool);
+        for (long s = 0; s < steps; s++)
+            integ.step(b, dt);
+    }, 1);
+    report("float", r, b, max_dv(b));
+
+    for (auto acc: {MixedStepper::Double, MixedStepper::Compensated}) {
+        char const *name = acc == MixedStepper::Double ? "mixed" : "mixed-kahan";
+        MixedBodies mb;
+        r = benchmark(std::string("mixed/") + name, [&] { mb = MixedBodies::from(init_state); },
+                      [&](WorkStealingPool &pool) {
+            MixedStepper stepper(pool, acc);
+            for (long s = 0; s < steps; s++)
+                stepper.step(mb);
+        }, 1);
+        mb.store(b);
+        report(name, r, b, max_dv(mb));
+    }
+
+    MixedBodies db;
+    r = benchmark("mixed/double", [&] { db = MixedBodies::from(init_state); }, [&] {
+        for (long s = 0; s < steps; s++)
+            step_double(db);
+    });
+    db.store(b);
+    report("double", r, b, max_dv(db));
+    return 0;
+}
@@ -0,0 +1,55 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include "nbody.h"
+#include "morton.h"
+#include "rng.h"
+#include "benchmark.h"
+
+// 抽样一些粒子，暴力找最近邻，统计它们在数组里的下标距离的中位数
+static size_t median_neighbour_gap(Bodies const &b, size_t samples) {
+    std::vector<size_t> gaps;
+    for (size_t s = 0; s < samples; s++) {
+        size_t i = counter_rng(7, s, 0) % b.size();
+        size_t best = i;
+        float best_d2 = INFINITY;
+        for (size_t j = 0; j < b.size(); j++) {
+            float dx = b.px[j] - b.px[i], dy = b.py[j] - b.py[i], dz = b.pz[j] - b.pz[i];
+            float d2 = dx * dx + dy * dy + dz * dz;
+            if (j != i && d2 < best_d2) {
+                best_d2 = d2;
+                best = j;
+            }
+        }
+        gaps.push_back(best > i ? best - i : i - best);
+    }
+    std::nth_element(gaps.begin(), gaps.begin() + gaps.size() / 2, gaps.end());
+    return gaps[gaps.size() / 2];
+}
+
+// Morton 重排的开销，以及重排前后空间近邻在内存中的距离
+// 用法: ./bench_morton [N]
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? atol(argv[1]) : 1 << 20;
+    unsigned nthreads = std::max(1u, std::thread::hardware_concurrency());
+    Bodies b = make_bodies(n);
+    printf("N=%zu threads=%u\n", n, nthreads);
+    printf("median nearest-neighbour index gap before: %zu\n", median_neighbour_gap(b, 200));
+    for (unsigned t = 1;; t = std::min(t * 2, nthreads)) {
+        Bodies c;
+        auto r = benchmark("morton/reorder/t=" + std::to_string(t), [&] { c = b; },
+                           [&](WorkStealingPool &pool) {
+            SpatialSorter sorter(pool);
+            sorter.reorder(c);
+        }, t);
+        printf("reorder with %2u threads: %.3f ms ±%.2f%%\n", t, r.ms(), r.rel_ci() * 100);
+        if (t == nthreads) {
+            printf("median nearest-neighbour index gap after:  %zu\n", median_neighbour_gap(c, 200));
+            break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,50 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include "nbody.h"
+#include "neighbor.h"
+#include "benchmark.h"
+
+// 截断力的短程模拟：近邻表重建与力计算的用时，以及 Morton 重排的影响
+// 用法: ./bench_neighbor [N] [steps] [平均近邻数]
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? atol(argv[1]) : 1000000;
+    int steps = argc > 2 ? atoi(argv[2]) : 20;
+    float nn = argc > 3 ? atof(argv[3]) : 30;
+    unsigned nthreads = std::max(1u, std::thread::hardware_concurrency());
+    // 体积 8 的立方体里，半径 r 的球平均包含 nn 个粒子
+    float rc = std::cbrt(3 * nn * 8 / (4 * (float)M_PI * n));
+    float skin = 0.2f * rc;
+    // 软化长度跟着截断半径放大，否则随机撒点产生的极近粒子对会被一步踢飞，近邻表每步都要重建
+    eps = 0.25f * rc;
+
+    // 初速度也按截断半径缩放，使每步位移相对 skin 的比例不随 N 变化
+    Bodies init_state = make_bodies(n);
+    for (auto *v: {&init_state.vx, &init_state.vy, &init_state.vz})
+        for (auto &x: *v)
+            x *= rc;
+
+    printf("N=%zu steps=%d threads=%u cutoff=%g skin=%g\n", n, steps, nthreads, rc, skin);
+    printf("%8s %10s %9s %12s %10s %12s\n", "reorder", "total ms", "rebuilds", "rebuild ms", "force ms", "pairs/body");
+    for (bool reorder: {false, true}) {
+        Bodies b;
+        WorkStealingPool pool(nthreads);
+        std::unique_ptr<NeighborStepper> stepper;
+        char const *name = reorder ? "morton" : "none";
+        auto r = benchmark(std::string("neighbor/") + name, [&] {
+            b = init_state;
+            stepper = std::make_unique<NeighborStepper>(pool, rc, skin, reorder);
+        }, [&] {
+            for (int s = 0; s < steps; s++)
+                stepper->step(b);
+        });
+        printf("%8s %10.1f %9zu %12.1f %10.1f %12.1f\n", name, r.ms(),
+               stepper->rebuilds(), stepper->rebuild_ms(), stepper->force_ms(),
+               (double)stepper->pairs() / n);
+    }
+    return 0;
+}
@@ -0,0 +1,45 @@
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include "nbody.h"
+#include "parallel.h"
+#include "benchmark.h"
+
+// 强扩展性：固定 N，线程数从 1 翻倍到核数
+// 用法: ./bench_scaling [最大N]
+int main(int argc, char **argv) {
+    size_t max_n = argc > 1 ? atol(argv[1]) : 65536;
+    unsigned max_threads = std::thread::hardware_concurrency();
+    if (max_threads == 0)
+        max_threads = 1;
+    printf("%8s %8s %6s %10s %7s %8s %8s %10s\n",
+           "N", "threads", "steps", "ms", "±%", "speedup", "effic", "Gpair/s");
+    for (size_t n = 1024; n <= max_n; n *= 2) {
+        Bodies init_state = make_bodies(n);
+        double pairs = (double)n * (n - 1) / 2;
+        int steps = std::max(1, (int)((1 << 28) / pairs));
+        double base = 0;
+        for (unsigned t = 1;; t = std::min(t * 2, max_threads)) {
+            Bodies b;
+            auto r = benchmark("scaling/N=" + std::to_string(n) + "/t=" + std::to_string(t),
+                               [&] { b = init_state; }, [&](WorkStealingPool &pool) {
+                ParallelStepper stepper(pool);
+                for (int s = 0; s < steps; s++)
+                    stepper.step(b);
+            }, t);
+            double ms = r.ms();
+            if (t == 1)
+                base = ms;
+            double speedup = base / ms;
+            printf("%8zu %8u %6d %10.3f %7.2f %8.2f %8.2f %10.3f\n",
+                   n, t, steps, ms, r.rel_ci() * 100, speedup, speedup / t,
+                   pairs * steps / ms * 1e-6);
+            if (t == max_threads)
+                break;
+        }
+    }
+    return 0;
+}
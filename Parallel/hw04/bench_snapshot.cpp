@@ -0,0 +1,53 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include "nbody.h"
+#include "parallel.h"
+#include "snapshot.h"
+#include "benchmark.h"
+
+// 每 K 步写一次快照对单步用时的影响（K = 0 表示不写）
+// 用法: ./bench_snapshot [N] [steps] [前缀]
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? atol(argv[1]) : 8192;
+    int steps = argc > 2 ? atoi(argv[2]) : 100;
+    std::string prefix = argc > 3 ? argv[3] : "snap";
+    unsigned nthreads = std::max(1u, std::thread::hardware_concurrency());
+    Bodies init_state = make_bodies(n);
+
+    printf("N=%zu steps=%d threads=%u\n", n, steps, nthreads);
+    printf("%6s %10s %12s\n", "K", "ms", "ms/step");
+    uint64_t last_step = 0;
+    Bodies last;
+    for (int k: {0, 50, 10, 1}) {
+        Bodies b;
+        auto r = benchmark("snapshot/K=" + std::to_string(k), [&] { b = init_state; },
+                           [&](WorkStealingPool &pool) {
+            ParallelStepper stepper(pool);
+            SnapshotWriter writer(prefix);
+            for (int s = 1; s <= steps; s++) {
+                stepper.step(b);
+                if (k && s % k == 0) {
+                    writer.submit(b, s, s * dt);
+                    last_step = s;
+                }
+            }
+            writer.flush();
+        }, nthreads);
+        printf("%6d %10.3f %12.4f\n", k, r.ms(), r.ms() / steps);
+        last = b;
+    }
+
+    // 从最后一份快照重启，应当和内存里的状态逐位一致
+    uint64_t step;
+    double time;
+    Bodies restored = load_snapshot(SnapshotWriter(prefix).path_for(last_step), &step, &time);
+    bool same = restored.size() == last.size();
+    for (auto f: {&Bodies::px, &Bodies::py, &Bodies::pz, &Bodies::vx, &Bodies::vy, &Bodies::vz, &Bodies::mass})
+        same = same && memcmp((restored.*f).data(), (last.*f).data(), n * sizeof(float)) == 0;
+    printf("restart from step %llu (t=%g): %s\n", (unsigned long long)step, time,
+           same ? "identical" : "MISMATCH");
+    return same ? 0 : 1;
+}
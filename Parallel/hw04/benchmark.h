@@ -0,0 +1,37 @@
+#pragma once
+#include "pool.h"
+#include "benchlib.h"
+#include <atomic>
+#include <string>
+#include <thread>
+
+// 池里每个线程各领一个任务并在栅栏处等齐，保证 tid 与线程一一对应，
+// 再把工作线程绑到 first_cpu + tid 上；调用线程 (tid 0) 由 benchlib::run 负责绑定和恢复
+inline void pin_pool(WorkStealingPool &pool, unsigned first_cpu) {
+    std::atomic<unsigned> arrived{0};
+    pool.run(pool.size(), [&](size_t, unsigned tid) {
+        if (tid != 0)
+            benchlib::pin_thread(first_cpu + tid);
+        arrived++;
+        while (arrived.load() < pool.size())
+            std::this_thread::yield();
+    });
+}
+
+// 预热后反复计时 func()，直到中位数的置信区间足够窄（见 benchlib::Options）
+// setup() 在每次计时之前执行、不计时，用来把被推进过的状态复原
+template <class Setup, class Func>
+benchlib::Result benchmark(std::string const &name, Setup const &setup, Func const &func) {
+    return benchlib::run(name, func, setup);
+}
+
+// 线程池在计时之外创建，只有 func(pool) 计入用时；设置了 BENCH_CPU 时池里的线程依次绑核
+template <class Setup, class Func>
+benchlib::Result benchmark(std::string const &name, Setup const &setup, Func const &func,
+                           unsigned nthreads) {
+    auto opt = benchlib::Options::from_env();
+    WorkStealingPool pool(nthreads);
+    if (opt.cpu >= 0)
+        pin_pool(pool, opt.cpu);
+    return benchlib::run(name, [&] { func(pool); }, setup, opt);
+}
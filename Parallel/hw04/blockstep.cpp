@@ -0,0 +1,170 @@
+#include "blockstep.h"
+#include <algorithm>
+#include <cmath>
+
+template <class Law>
+BasicBlockStepper<Law>::BasicBlockStepper(WorkStealingPool &pool, float dt_max, int max_level, float eta)
+    : m_pool(pool), m_dt_max(dt_max), m_max_level(std::clamp(max_level, 0, 30)), m_eta(eta) {
+}
+
+// Gadget 式判据 dt = sqrt(2 eta eps / |a|)，取不超过它的最大 2 的幂分级
+template <class Law>
+int BasicBlockStepper<Law>::pick_level(size_t i) const {
+    float a = std::sqrt(m_ax[i] * m_ax[i] + m_ay[i] * m_ay[i] + m_az[i] * m_az[i]);
+    if (a == 0)
+        return 0;
+    float h = std::sqrt(2 * m_eta * eps / a);
+    int level = (int)std::ceil(std::log2(m_dt_max / h));
+    return std::clamp(level, 0, m_max_level);
+}
+
+template <class Law>
+int BasicBlockStepper<Law>::finest_level() const {
+    int level = 0;
+    for (int l: m_level)
+        level = std::max(level, l);
+    return level;
+}
+
+template <class Law>
+void BasicBlockStepper<Law>::predict(Bodies &b, uint64_t tick) {
+    float h = std::ldexp(m_dt_max, -m_max_level);
+    for (size_t i = 0; i < b.size(); i++) {
+        float dt_i = (tick - m_t0[i]) * h;
+        b.px[i] = m_x0[i] + b.vx[i] * dt_i;
+        b.py[i] = m_y0[i] + b.vy[i] * dt_i;
+        b.pz[i] = m_z0[i] + b.vz[i] * dt_i;
+    }
+}
+
+template <class Law>
+void BasicBlockStepper<Law>::gather_active(Bodies const &b, uint64_t tick) {
+    m_act.clear();
+    m_apx.clear();
+    m_apy.clear();
+    m_apz.clear();
+    for (size_t i = 0; i < b.size(); i++) {
+        uint64_t period = uint64_t(1) << (m_max_level - m_level[i]);
+        if (tick % period == 0) {
+            m_act.push_back(i);
+            m_apx.push_back(b.px[i]);
+            m_apy.push_back(b.py[i]);
+            m_apz.push_back(b.pz[i]);
+        }
+    }
+}
+
+template <class Law>
+void BasicBlockStepper<Law>::compute_active(Bodies const &b) {
+    size_t n = b.size(), na = m_act.size();
+    m_aax.resize(na);
+    m_aay.resize(na);
+    m_aaz.resize(na);
+    float const *px = b.px.data(), *py = b.py.data(), *pz = b.pz.data();
+    float const *m = b.mass.data();
+    Law const law(eps);
+    m_pool.parallel_for(na, 16, [&](size_t begin, size_t end, unsigned) {
+        for (size_t k = begin; k < end; k++) {
+            float xi = m_apx[k], yi = m_apy[k], zi = m_apz[k];
+            float sx = 0, sy = 0, sz = 0;
+#pragma omp simd reduction(+:sx, sy, sz)
+            for (size_t j = 0; j < n; j++) {
+                float dx = px[j] - xi;
+                float dy = py[j] - yi;
+                float dz = pz[j] - zi;
+                float r2 = dx * dx + dy * dy + dz * dz;
+                float f = m[j] * law.force(r2);
+                sx += dx * f;
+                sy += dy * f;
+                sz += dz * f;
+            }
+            m_aax[k] = sx * G;
+            m_aay[k] = sy * G;
+            m_aaz[k] = sz * G;
+        }
+    });
+    for (size_t k = 0; k < na; k++) {
+        m_ax[m_act[k]] = m_aax[k];
+        m_ay[m_act[k]] = m_aay[k];
+        m_az[m_act[k]] = m_aaz[k];
+    }
+    m_evals += na;
+}
+
+template <class Law>
+void BasicBlockStepper<Law>::begin(Bodies &b) {
+    size_t n = b.size();
+    m_level.assign(n, 0);
+    m_ax.assign(n, 0);
+    m_ay.assign(n, 0);
+    m_az.assign(n, 0);
+    m_x0 = b.px;
+    m_y0 = b.py;
+    m_z0 = b.pz;
+    m_t0.assign(n, 0);
+    gather_active(b, 0);
+    compute_active(b);
+    for (size_t i = 0; i < n; i++) {
+        m_level[i] = pick_level(i);
+        m_deepest = std::max(m_deepest, m_level[i]);
+        float half = std::ldexp(m_dt_max, -m_level[i]) / 2;
+        b.vx[i] += m_ax[i] * half;
+        b.vy[i] += m_ay[i] * half;
+        b.vz[i] += m_az[i] * half;
+    }
+}
+
+template <class Law>
+void BasicBlockStepper<Law>::step(Bodies &b) {
+    uint64_t ticks = uint64_t(1) << m_max_level;
+    uint64_t t = 0;
+    while (t < ticks) {
+        // 直接跳到下一个有粒子到期的时刻
+        t += uint64_t(1) << (m_max_level - finest_level());
+        predict(b, t);
+        gather_active(b, t);
+        compute_active(b);
+        for (uint32_t i: m_act) {
+            // 先用新力补完本级的后半步 kick，再换级开始下一步
+            float half = std::ldexp(m_dt_max, -m_level[i]) / 2;
+            int level = pick_level(i);
+            // 变细随时可以；变粗要等对齐到粗一级的步长边界
+            while (t % (uint64_t(1) << (m_max_level - level)) != 0)
+                level++;
+            m_level[i] = level;
+            m_deepest = std::max(m_deepest, level);
+            half += std::ldexp(m_dt_max, -level) / 2;
+            b.vx[i] += m_ax[i] * half;
+            b.vy[i] += m_ay[i] * half;
+            b.vz[i] += m_az[i] * half;
+            m_x0[i] = b.px[i];
+            m_y0[i] = b.py[i];
+            m_z0[i] = b.pz[i];
+            m_t0[i] = t;
+        }
+    }
+    // 一个 dt_max 结束时所有级都对齐，全部粒子刚 kick 过
+    std::fill(m_t0.begin(), m_t0.end(), 0);
+}
+
+template <class Law>
+void BasicBlockStepper<Law>::finish(Bodies &b) {
+    for (size_t i = 0; i < b.size(); i++) {
+        float half = std::ldexp(m_dt_max, -m_level[i]) / 2;
+        b.vx[i] -= m_ax[i] * half;
+        b.vy[i] -= m_ay[i] * half;
+        b.vz[i] -= m_az[i] * half;
+    }
+}
+
+template <class Law>
+std::vector<size_t> BasicBlockStepper<Law>::level_histogram() const {
+    std::vector<size_t> hist(m_max_level + 1);
+    for (int l: m_level)
+        hist[l]++;
+    return hist;
+}
+
+template class BasicBlockStepper<PlummerLaw>;
+template class BasicBlockStepper<SplineLaw>;
+template class BasicBlockStepper<CoulombLaw>;
@@ -0,0 +1,49 @@
+#pragma once
+#include "nbody.h"
+#include "pool.h"
+#include "force_law.h"
+#include <cstdint>
+#include <vector>
+
+// 分层块时间步：粒子按加速度分到 dt_max / 2^level 的各级，
+// 每个子步只有到期的那几级重新算力并 kick（KDK 蛙跳），其余粒子的位置按匀速外推
+// Law 是编译期的力律策略（force_law.h），实现在 blockstep.cpp 里对各个力律显式实例化
+template <class Law>
+class BasicBlockStepper {
+public:
+    BasicBlockStepper(WorkStealingPool &pool, float dt_max, int max_level = 12, float eta = 0.02f);
+
+    void begin(Bodies &b);  // 算初始力、分级、开头的半步 kick
+    void step(Bodies &b);   // 推进一个 dt_max
+    void finish(Bodies &b); // 撤回挂起的半步 kick，使 v 与 p 同步
+
+    uint64_t force_evaluations() const noexcept { return m_evals; }
+    std::vector<size_t> level_histogram() const;
+    int deepest_level() const noexcept { return m_deepest; }
+
+private:
+    int pick_level(size_t i) const;
+    int finest_level() const;
+    void predict(Bodies &b, uint64_t tick);
+    void gather_active(Bodies const &b, uint64_t tick);
+    void compute_active(Bodies const &b);
+
+    WorkStealingPool &m_pool;
+    float m_dt_max;
+    int m_max_level;
+    float m_eta;
+    int m_deepest = 0;
+    uint64_t m_evals = 0;
+
+    std::vector<int> m_level;
+    // 每个粒子上次 kick 时的位置和时刻，预测位置都从这里外推，避免每个小子步都累积舍入误差
+    std::vector<float> m_x0, m_y0, m_z0;
+    std::vector<uint64_t> m_t0;
+    std::vector<float> m_ax, m_ay, m_az;
+    // 当前子步到期的粒子，压缩成连续的 SoA 方便向量化
+    std::vector<uint32_t> m_act;
+    std::vector<float> m_apx, m_apy, m_apz;
+    std::vector<float> m_aax, m_aay, m_aaz;
+};
+
+using BlockStepper = BasicBlockStepper<PlummerLaw>;
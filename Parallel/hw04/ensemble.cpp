@@ -0,0 +1,90 @@
+#include "ensemble.h"
+#include <cmath>
+
+template <class Law>
+BasicEnsemble<Law>::BasicEnsemble(size_t nsystems, size_t nbodies)
+    : m_nsystems(nsystems), m_nbodies(nbodies),
+      m_nbatches((nsystems + kLanes - 1) / kLanes),
+      m_data(m_nbatches * kFields * nbodies * kLanes, 0.0f) {
+    // 补齐用的空通道质量为 0、位置全为 0，只会算出 0 的力
+}
+
+template <class Law>
+void BasicEnsemble<Law>::init(uint64_t first_seed) {
+    for (size_t s = 0; s < m_nsystems; s++)
+        load(s, make_bodies(m_nbodies, first_seed + s));
+}
+
+template <class Law>
+void BasicEnsemble<Law>::load(size_t s, Bodies const &b) {
+    size_t k = s / kLanes, l = s % kLanes;
+    std::vector<float> const *src[kFields] = {&b.px, &b.py, &b.pz, &b.vx, &b.vy, &b.vz, &b.mass};
+    for (int f = 0; f < kFields; f++)
+        for (size_t i = 0; i < m_nbodies; i++)
+            lanes(k, (Field)f, i)[l] = (*src[f])[i];
+}
+
+template <class Law>
+Bodies BasicEnsemble<Law>::extract(size_t s) const {
+    size_t k = s / kLanes, l = s % kLanes;
+    Bodies b;
+    b.resize(m_nbodies);
+    std::vector<float> *dst[kFields] = {&b.px, &b.py, &b.pz, &b.vx, &b.vy, &b.vz, &b.mass};
+    for (int f = 0; f < kFields; f++)
+        for (size_t i = 0; i < m_nbodies; i++)
+            (*dst[f])[i] = lanes(k, (Field)f, i)[l];
+    return b;
+}
+
+template <class Law>
+void BasicEnsemble<Law>::step_batch(size_t k) {
+    Law const law(eps);
+    float gdt = G * dt;
+    for (size_t i = 0; i < m_nbodies; i++) {
+        float const *xi = lanes(k, PX, i), *yi = lanes(k, PY, i), *zi = lanes(k, PZ, i);
+        float sx[kLanes] = {}, sy[kLanes] = {}, sz[kLanes] = {};
+        for (size_t j = 0; j < m_nbodies; j++) {
+            float const *xj = lanes(k, PX, j), *yj = lanes(k, PY, j), *zj = lanes(k, PZ, j);
+            float const *mj = lanes(k, MASS, j);
+#pragma omp simd
+            for (size_t l = 0; l < kLanes; l++) {
+                float dx = xj[l] - xi[l];
+                float dy = yj[l] - yi[l];
+                float dz = zj[l] - zi[l];
+                float r2 = dx * dx + dy * dy + dz * dz;
+                float f = mj[l] * law.force(r2);
+                sx[l] += dx * f;
+                sy[l] += dy * f;
+                sz[l] += dz * f;
+            }
+        }
+        float *vx = lanes(k, VX, i), *vy = lanes(k, VY, i), *vz = lanes(k, VZ, i);
+#pragma omp simd
+        for (size_t l = 0; l < kLanes; l++) {
+            vx[l] += sx[l] * gdt;
+            vy[l] += sy[l] * gdt;
+            vz[l] += sz[l] * gdt;
+        }
+    }
+    for (size_t i = 0; i < m_nbodies; i++) {
+        float *px = lanes(k, PX, i), *py = lanes(k, PY, i), *pz = lanes(k, PZ, i);
+        float const *vx = lanes(k, VX, i), *vy = lanes(k, VY, i), *vz = lanes(k, VZ, i);
+#pragma omp simd
+        for (size_t l = 0; l < kLanes; l++) {
+            px[l] += vx[l] * dt;
+            py[l] += vy[l] * dt;
+            pz[l] += vz[l] * dt;
+        }
+    }
+}
+
+template <class Law>
+void BasicEnsemble<Law>::step(WorkStealingPool &pool) {
+    pool.run(m_nbatches, [&](size_t k, unsigned) {
+        step_batch(k);
+    });
+}
+
+template class BasicEnsemble<PlummerLaw>;
+template class BasicEnsemble<SplineLaw>;
+template class BasicEnsemble<CoulombLaw>;
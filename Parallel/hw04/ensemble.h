@@ -0,0 +1,46 @@
+#pragma once
+#include "nbody.h"
+#include "pool.h"
+#include "force_law.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// 大量互相独立的小系统一起算：SIMD 跨系统排布，第 l 条通道就是批内第 l 个系统，
+// 所有系统步调一致，内层循环沿通道方向没有归约，天然向量化；不同批分给不同线程
+// Law 是编译期的力律策略（force_law.h），实现在 ensemble.cpp 里对各个力律显式实例化
+template <class Law>
+class BasicEnsemble {
+public:
+    static constexpr size_t kLanes = 16;
+
+    BasicEnsemble(size_t nsystems, size_t nbodies);
+
+    // 第 s 个系统用种子 first_seed + s，分布与 init() 相同
+    void init(uint64_t first_seed);
+    void load(size_t s, Bodies const &b);
+    Bodies extract(size_t s) const;
+
+    void step(WorkStealingPool &pool);
+
+    size_t systems() const noexcept { return m_nsystems; }
+    size_t bodies() const noexcept { return m_nbodies; }
+
+private:
+    enum Field { PX, PY, PZ, VX, VY, VZ, MASS, kFields };
+
+    // 批 k 的字段 f、粒子 i 的 kLanes 个通道是连续的
+    float *lanes(size_t k, Field f, size_t i) noexcept {
+        return m_data.data() + ((k * kFields + f) * m_nbodies + i) * kLanes;
+    }
+    float const *lanes(size_t k, Field f, size_t i) const noexcept {
+        return m_data.data() + ((k * kFields + f) * m_nbodies + i) * kLanes;
+    }
+
+    void step_batch(size_t k);
+
+    size_t m_nsystems, m_nbodies, m_nbatches;
+    std::vector<float> m_data;
+};
+
+using Ensemble = BasicEnsemble<PlummerLaw>;
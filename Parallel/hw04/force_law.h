@@ -0,0 +1,67 @@
+#pragma once
+#include <cmath>
+
+// 力律策略：构造时传入软化长度，force(r2) 返回 f，使得
+//   a_i += G * m_j * f * (x_j - x_i)
+// potential(r2) 返回 phi，使得 U_ij = -G * m_i * m_j * phi
+// 都是内联的小函数，在成对内核模板里展开，内层循环没有运行期分派
+
+// Plummer 软化，即原 step() / calc() 的 d2 + eps * eps
+struct PlummerLaw {
+    float eps2;
+
+    explicit PlummerLaw(float eps) : eps2(eps * eps) {}
+
+    float force(float r2) const {
+        float d2 = r2 + eps2;
+        return 1 / (d2 * std::sqrt(d2));
+    }
+
+    float potential(float r2) const {
+        return 1 / std::sqrt(r2 + eps2);
+    }
+};
+
+// 三次样条核软化（Monaghan & Lattanzio 1985，系数同 Gadget-2），h = 2.8 eps，
+// r >= h 时精确等于牛顿引力
+struct SplineLaw {
+    float h, hinv, hinv3;
+
+    explicit SplineLaw(float eps) : h(2.8f * eps), hinv(1 / h), hinv3(hinv * hinv * hinv) {}
+
+    float force(float r2) const {
+        float r = std::sqrt(r2);
+        float u = r * hinv;
+        float inner = hinv3 * (10.666667f + u * u * (32.0f * u - 38.4f));
+        float outer = hinv3 * (21.333333f - 48.0f * u + 38.4f * u * u
+                               - 10.666667f * u * u * u - 0.06666667f / (u * u * u));
+        float newton = 1 / (r2 * r);
+        return u < 0.5f ? inner : u < 1 ? outer : newton;
+    }
+
+    float potential(float r2) const {
+        float r = std::sqrt(r2);
+        float u = r * hinv;
+        float inner = hinv * (2.8f - u * u * (5.333333f + u * u * (6.4f * u - 9.6f)));
+        float outer = hinv * (3.2f - 0.06666667f / u
+                              - u * u * (10.666667f + u * (-16.0f + u * (9.6f - 2.133333f * u))));
+        float newton = 1 / r;
+        return u < 0.5f ? inner : u < 1 ? outer : newton;
+    }
+};
+
+// 类库仑相互作用：同号电荷相斥，质量字段兼作电荷，G 兼作耦合常数，Plummer 软化
+struct CoulombLaw {
+    float eps2;
+
+    explicit CoulombLaw(float eps) : eps2(eps * eps) {}
+
+    float force(float r2) const {
+        float d2 = r2 + eps2;
+        return -1 / (d2 * std::sqrt(d2));
+    }
+
+    float potential(float r2) const {
+        return -1 / std::sqrt(r2 + eps2);
+    }
+};
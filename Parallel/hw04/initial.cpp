@@ -0,0 +1,95 @@
+#include "initial.h"
+#include "rng.h"
+#include <cmath>
+
+namespace {
+
+template <class Func>
+void for_chunks(size_t n, WorkStealingPool *pool, Func const &func) {
+    if (pool)
+        pool->parallel_for(n, 16384, [&](size_t begin, size_t end, unsigned) {
+            func(begin, end);
+        });
+    else
+        func(0, n);
+}
+
+}
+
+// 每个字段单独一个循环，循环体只有整数混合和乘法，可以向量化
+Bodies uniform_cube(size_t n, uint64_t seed, WorkStealingPool *pool) {
+    Bodies b;
+    b.resize(n);
+    std::vector<float> *fields[] = {&b.px, &b.py, &b.pz, &b.vx, &b.vy, &b.vz, &b.mass};
+    for_chunks(n, pool, [&](size_t begin, size_t end) {
+        for (int f = 0; f < 7; f++) {
+            float *out = fields[f]->data();
+            for (size_t i = begin; i < end; i++)
+                out[i] = frand(seed, i, f);
+        }
+        for (size_t i = begin; i < end; i++)
+            b.mass[i] += 1;
+    });
+    return b;
+}
+
+Bodies plummer(size_t n, uint64_t seed, float total_mass, float radius, WorkStealingPool *pool) {
+    Bodies b;
+    b.resize(n);
+    float vscale = std::sqrt(G * total_mass / radius);
+    for_chunks(n, pool, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            uint64_t k = 0;
+            auto u = [&] { return uniform01(seed, i, k++); };
+            // 半径：累积质量分布取反函数，截断在 10 倍尺度半径内
+            float r;
+            do {
+                float x = u();
+                r = 1 / std::sqrt(std::pow(x, -2.0f / 3) - 1);
+            } while (!(r < 10));
+            float ct = 2 * u() - 1, phi = 2 * (float)M_PI * u();
+            float st = std::sqrt(1 - ct * ct);
+            b.px[i] = radius * r * st * std::cos(phi);
+            b.py[i] = radius * r * st * std::sin(phi);
+            b.pz[i] = radius * r * ct;
+            // 速度大小：对 g(q) = q^2 (1 - q^2)^3.5 做拒绝采样，q = v / v_escape
+            float q, y;
+            do {
+                q = u();
+                y = 0.1f * u();
+            } while (y > q * q * std::pow(1 - q * q, 3.5f));
+            float v = q * std::sqrt(2.0f) * std::pow(1 + r * r, -0.25f);
+            ct = 2 * u() - 1;
+            phi = 2 * (float)M_PI * u();
+            st = std::sqrt(1 - ct * ct);
+            b.vx[i] = vscale * v * st * std::cos(phi);
+            b.vy[i] = vscale * v * st * std::sin(phi);
+            b.vz[i] = vscale * v * ct;
+            b.mass[i] = total_mass / n;
+        }
+    });
+    return b;
+}
+
+Bodies disk(size_t n, uint64_t seed, float total_mass, float radius, float thickness,
+            WorkStealingPool *pool) {
+    Bodies b;
+    b.resize(n);
+    for_chunks(n, pool, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            float r = radius * std::sqrt(uniform01(seed, i, 0));
+            float phi = 2 * (float)M_PI * uniform01(seed, i, 1);
+            float c = std::cos(phi), s = std::sin(phi);
+            b.px[i] = r * c;
+            b.py[i] = r * s;
+            b.pz[i] = thickness * frand(seed, i, 2);
+            // 均匀盘内 M(<r) = M r^2 / R^2，按球对称近似取 v = sqrt(G M(<r) / r)
+            float v = std::sqrt(G * total_mass * r) / radius;
+            b.vx[i] = -v * s;
+            b.vy[i] = v * c;
+            b.vz[i] = 0;
+            b.mass[i] = total_mass / n;
+        }
+    });
+    return b;
+}
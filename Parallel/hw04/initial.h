@@ -0,0 +1,18 @@
+#pragma once
+#include "nbody.h"
+#include "pool.h"
+#include <cstdint>
+
+// 初始条件生成器：第 i 个粒子只依赖 (seed, i)，与线程数无关、逐位可复现
+// pool 为空时在调用线程上生成
+
+// 与原 init() 相同的分布：位置、速度在 [-1, 1)^3 内均匀，质量在 [0, 2)
+Bodies uniform_cube(size_t n, uint64_t seed, WorkStealingPool *pool = nullptr);
+
+// Plummer 球（Aarseth, Hénon & Wielen 1974），总质量 total_mass，尺度半径 radius，处于维里平衡
+Bodies plummer(size_t n, uint64_t seed, float total_mass, float radius = 1,
+               WorkStealingPool *pool = nullptr);
+
+// xy 平面内面密度均匀的薄盘，速度取圆轨道速度
+Bodies disk(size_t n, uint64_t seed, float total_mass, float radius = 1,
+            float thickness = 0.01f, WorkStealingPool *pool = nullptr);
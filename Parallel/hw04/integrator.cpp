@@ -0,0 +1,96 @@
+#include "integrator.h"
+#include <cmath>
+#include <utility>
+
+Integrator euler() {
+    return {"euler", 0.0f, {{1.0f, 1.0f}}, 0.0f};
+}
+
+Integrator leapfrog() {
+    return {"leapfrog", 0.5f, {{1.0f, 1.0f}}, -0.5f};
+}
+
+Integrator yoshida4() {
+    double cbrt2 = std::cbrt(2.0);
+    double w1 = 1 / (2 - cbrt2);
+    double w0 = -cbrt2 / (2 - cbrt2);
+    float c1 = w1 / 2, c2 = (w0 + w1) / 2;
+    float d1 = w1, d2 = w0;
+    return {"yoshida4", c1, {{d1, c2}, {d2, c2}, {d1, 2 * c1}}, -c1};
+}
+
+template <class Law>
+BasicFusedIntegrator<Law>::BasicFusedIntegrator(Integrator scheme, WorkStealingPool &pool)
+    : m_scheme(std::move(scheme)), m_pool(pool) {
+}
+
+template <class Law>
+void BasicFusedIntegrator<Law>::drift(Bodies &b, float ddt) {
+    if (ddt == 0)
+        return;
+    m_pool.parallel_for(b.size(), 4096, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; i++) {
+            b.px[i] += b.vx[i] * ddt;
+            b.py[i] += b.vy[i] * ddt;
+            b.pz[i] += b.vz[i] * ddt;
+        }
+    });
+}
+
+template <class Law>
+void BasicFusedIntegrator<Law>::kick_drift(Bodies &b, float kdt, float ddt) {
+    size_t n = b.size();
+    m_qx.resize(n);
+    m_qy.resize(n);
+    m_qz.resize(n);
+    float const *px = b.px.data(), *py = b.py.data(), *pz = b.pz.data();
+    float const *m = b.mass.data();
+    Law const law(eps);
+    float gk = G * kdt;
+    m_pool.parallel_for(n, 64, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; i++) {
+            float xi = px[i], yi = py[i], zi = pz[i];
+            float sx = 0, sy = 0, sz = 0;
+#pragma omp simd reduction(+:sx, sy, sz)
+            for (size_t j = 0; j < n; j++) {
+                float dx = px[j] - xi;
+                float dy = py[j] - yi;
+                float dz = pz[j] - zi;
+                float r2 = dx * dx + dy * dy + dz * dz;
+                float f = m[j] * law.force(r2);
+                sx += dx * f;
+                sy += dy * f;
+                sz += dz * f;
+            }
+            float vx = b.vx[i] += sx * gk;
+            float vy = b.vy[i] += sy * gk;
+            float vz = b.vz[i] += sz * gk;
+            m_qx[i] = xi + vx * ddt;
+            m_qy[i] = yi + vy * ddt;
+            m_qz[i] = zi + vz * ddt;
+        }
+    });
+    b.px.swap(m_qx);
+    b.py.swap(m_qy);
+    b.pz.swap(m_qz);
+}
+
+template <class Law>
+void BasicFusedIntegrator<Law>::begin(Bodies &b, float h) {
+    drift(b, m_scheme.open_drift * h);
+}
+
+template <class Law>
+void BasicFusedIntegrator<Law>::step(Bodies &b, float h) {
+    for (auto const &s: m_scheme.substeps)
+        kick_drift(b, s.kick * h, s.drift * h);
+}
+
+template <class Law>
+void BasicFusedIntegrator<Law>::finish(Bodies &b, float h) {
+    drift(b, m_scheme.close_drift * h);
+}
+
+template class BasicFusedIntegrator<PlummerLaw>;
+template class BasicFusedIntegrator<SplineLaw>;
+template class BasicFusedIntegrator<CoulombLaw>;
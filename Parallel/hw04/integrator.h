@@ -0,0 +1,49 @@
+#pragma once
+#include "nbody.h"
+#include "pool.h"
+#include "force_law.h"
+#include <vector>
+
+// 辛积分器都可以写成 “漂移 - (踢 - 漂移)×k” 的序列：
+// 每个子步先用当前位置算力并 kick (v += a * kick * dt)，紧接着 drift (p += v * drift * dt)
+// 相邻两步首尾的漂移合并掉，最后用 close_drift 撤回多走的那一段，让 p 和 v 同步
+struct Integrator {
+    struct Substep {
+        float kick, drift;
+    };
+    char const *name;
+    float open_drift;
+    std::vector<Substep> substeps;
+    float close_drift;
+};
+
+Integrator euler();    // 与原 step() 相同的半隐式欧拉
+Integrator leapfrog(); // DKD 蛙跳，即速度 Verlet，二阶
+Integrator yoshida4(); // Yoshida 四阶，每步 3 次力计算
+
+// 力计算和 kick/drift 融合在同一遍里：第 i 行算完立刻更新 v[i]，
+// 新位置写到另一块缓冲，整遍结束再交换，所以粒子数据每个子步只过一遍内存
+// Law 是编译期的力律策略（force_law.h），实现在 integrator.cpp 里对各个力律显式实例化
+template <class Law>
+class BasicFusedIntegrator {
+public:
+    BasicFusedIntegrator(Integrator scheme, WorkStealingPool &pool);
+
+    void begin(Bodies &b, float h);
+    void step(Bodies &b, float h);
+    void finish(Bodies &b, float h);
+
+    Integrator const &scheme() const noexcept {
+        return m_scheme;
+    }
+
+private:
+    void drift(Bodies &b, float ddt);
+    void kick_drift(Bodies &b, float kdt, float ddt);
+
+    Integrator m_scheme;
+    WorkStealingPool &m_pool;
+    std::vector<float> m_qx, m_qy, m_qz;
+};
+
+using FusedIntegrator = BasicFusedIntegrator<PlummerLaw>;
@@ -1,88 +1,34 @@
-#include <cstdio>
-#include <cstdlib>
-#include <vector>
-#include <chrono>
-#include <cmath>
-
-float frand() {
-    return (float)rand() / RAND_MAX * 2 - 1;
-}
-
-struct Star {
-    float px, py, pz;
-    float vx, vy, vz;
-    float mass;
-};
-
-std::vector<Star> stars;
-
-void init() {
-    for (int i = 0; i < 48; i++) {
-        stars.push_back({
-            frand(), frand(), frand(),
-            frand(), frand(), frand(),
-            frand() + 1,
-        });
-    }
-}
-
-float G = 0.001;
-float eps = 0.001;
-float dt = 0.01;
-
-void step() {
-    for (auto &star: stars) {
-        for (auto &other: stars) {
-            float dx = other.px - star.px;
-            float dy = other.py - star.py;
-            float dz = other.pz - star.pz;
-            float d2 = dx * dx + dy * dy + dz * dz + eps * eps;
-            d2 *= sqrt(d2);
-            star.vx += dx * other.mass * G * dt / d2;
-            star.vy += dy * other.mass * G * dt / d2;
-            star.vz += dz * other.mass * G * dt / d2;
-        }
-    }
-    for (auto &star: stars) {
-        star.px += star.vx * dt;
-        star.py += star.vy * dt;
-        star.pz += star.vz * dt;
-    }
-}
-
-float calc() {
-    float energy = 0;
-    for (auto &star: stars) {
-        float v2 = star.vx * star.vx + star.vy * star.vy + star.vz * star.vz;
-        energy += star.mass * v2 / 2;
-        for (auto &other: stars) {
-            float dx = other.px - star.px;
-            float dy = other.py - star.py;
-            float dz = other.pz - star.pz;
-            float d2 = dx * dx + dy * dy + dz * dz + eps * eps;
-            energy -= other.mass * star.mass * G / sqrt(d2) / 2;
-        }
-    }
-    return energy;
-}
-
-template <class Func>
-long benchmark(Func const &func) {
-    auto t0 = std::chrono::steady_clock::now();
-    func();
-    auto t1 = std::chrono::steady_clock::now();
-    auto dt = std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0);
-    return dt.count();
-}
-
-int main() {
-    init();
-    printf("Initial energy: %f\n", calc());
-    auto dt = benchmark([&] {
-        for (int i = 0; i < 100000; i++)
-            step();
-    });
-    printf("Final energy: %f\n", calc());
-    printf("Time elapsed: %ld ms\n", dt);
-    return 0;
-}
+#include <cstdio>
+#include <cstdlib>
+#include "nbody.h"
+#include "parallel.h"
+#include "benchmark.h"
+
+int main(int argc, char **argv) {
+    init();
+    printf("Initial energy: %f\n", calc());
+    benchlib::Result r;
+    if (argc > 1) {
+        // ./main <线程数>：用并行分块的 step
+        unsigned nthreads = atoi(argv[1]);
+        Bodies b;
+        r = benchmark("main/parallel", [&] {
+            init();
+            b = to_bodies(stars);
+        }, [&](WorkStealingPool &pool) {
+            ParallelStepper stepper(pool);
+            for (int i = 0; i < 100000; i++)
+                stepper.step(b);
+        }, nthreads);
+        to_stars(b, stars);
+    } else {
+        r = benchmark("main/step", init, [&] {
+            for (int i = 0; i < 100000; i++)
+                step();
+        });
+    }
+    printf("Final energy: %f\n", calc());
+    printf("Time elapsed: %.3f ms (median of %zu runs, ±%.2f%%, p95 %.3f ms)\n",
+           r.ms(), r.runs(), r.rel_ci() * 100, r.p95 * 1e-6);
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include "mixed.h"
+#include <algorithm>
+#include <cmath>
+
+MixedBodies MixedBodies::from(Bodies const &b) {
+    MixedBodies m;
+    m.px.assign(b.px.begin(), b.px.end());
+    m.py.assign(b.py.begin(), b.py.end());
+    m.pz.assign(b.pz.begin(), b.pz.end());
+    m.vx.assign(b.vx.begin(), b.vx.end());
+    m.vy.assign(b.vy.begin(), b.vy.end());
+    m.vz.assign(b.vz.begin(), b.vz.end());
+    m.mass = b.mass;
+    return m;
+}
+
+void MixedBodies::store(Bodies &b) const {
+    b.px.assign(px.begin(), px.end());
+    b.py.assign(py.begin(), py.end());
+    b.pz.assign(pz.begin(), pz.end());
+    b.vx.assign(vx.begin(), vx.end());
+    b.vy.assign(vy.begin(), vy.end());
+    b.vz.assign(vz.begin(), vz.end());
+    b.mass = mass;
+}
+
+template <class Law>
+BasicMixedStepper<Law>::BasicMixedStepper(WorkStealingPool &pool, Accumulation acc)
+    : m_pool(pool), m_acc(acc) {
+}
+
+template <class Law>
+template <typename BasicMixedStepper<Law>::Accumulation Acc>
+void BasicMixedStepper<Law>::kick(MixedBodies &b, size_t begin, size_t end, size_t block) {
+    size_t n = b.size();
+    float const *ox = m_ox.data(), *oy = m_oy.data(), *oz = m_oz.data();
+    float const *m = b.mass.data();
+    Law const law(eps);
+    double gdt = (double)G * dt;
+    for (size_t i = begin; i < end; i++) {
+        float xi = ox[i], yi = oy[i], zi = oz[i];
+        double ax = 0, ay = 0, az = 0;
+        float cx = 0, cy = 0, cz = 0; // Compensated 模式下的 Kahan 补偿项
+        float fx = 0, fy = 0, fz = 0;
+        for (size_t j0 = 0; j0 < n; j0 += block) {
+            size_t j1 = std::min(j0 + block, n);
+            float sx = 0, sy = 0, sz = 0;
+#pragma omp simd reduction(+:sx, sy, sz)
+            for (size_t j = j0; j < j1; j++) {
+                float dx = ox[j] - xi;
+                float dy = oy[j] - yi;
+                float dz = oz[j] - zi;
+                float r2 = dx * dx + dy * dy + dz * dz;
+                float f = m[j] * law.force(r2);
+                sx += dx * f;
+                sy += dy * f;
+                sz += dz * f;
+            }
+            if constexpr (Acc == Double) {
+                ax += sx;
+                ay += sy;
+                az += sz;
+            } else {
+                float y, t;
+                y = sx - cx; t = fx + y; cx = (t - fx) - y; fx = t;
+                y = sy - cy; t = fy + y; cy = (t - fy) - y; fy = t;
+                y = sz - cz; t = fz + y; cz = (t - fz) - y; fz = t;
+            }
+        }
+        if constexpr (Acc == Compensated) {
+            ax = fx;
+            ay = fy;
+            az = fz;
+        }
+        b.vx[i] += ax * gdt;
+        b.vy[i] += ay * gdt;
+        b.vz[i] += az * gdt;
+    }
+}
+
+template <class Law>
+void BasicMixedStepper<Law>::step(MixedBodies &b) {
+    size_t n = b.size();
+    if (n == 0)
+        return;
+    // 原点取质心附近的格点（边长为 2 的幂），原点本身能精确表示；偏移在 double 里算好再转成 float，
+    // 转换时仍有舍入，但误差只和偏移的大小成比例，不再和绝对坐标成比例
+    double cx = 0, cy = 0, cz = 0;
+    for (size_t i = 0; i < n; i++) {
+        cx += b.px[i];
+        cy += b.py[i];
+        cz += b.pz[i];
+    }
+    double cell = 1.0 / 1024;
+    cx = std::round(cx / n / cell) * cell;
+    cy = std::round(cy / n / cell) * cell;
+    cz = std::round(cz / n / cell) * cell;
+    m_ox.resize(n);
+    m_oy.resize(n);
+    m_oz.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        m_ox[i] = b.px[i] - cx;
+        m_oy[i] = b.py[i] - cy;
+        m_oz[i] = b.pz[i] - cz;
+    }
+    size_t block = std::clamp(n / 8 / kMinBlock * kMinBlock, kMinBlock, kBlock);
+    m_pool.parallel_for(n, 64, [&](size_t begin, size_t end, unsigned) {
+        if (m_acc == Double)
+            kick<Double>(b, begin, end, block);
+        else
+            kick<Compensated>(b, begin, end, block);
+    });
+    for (size_t i = 0; i < n; i++) {
+        b.px[i] += b.vx[i] * dt;
+        b.py[i] += b.vy[i] * dt;
+        b.pz[i] += b.vz[i] * dt;
+    }
+}
+
+template class BasicMixedStepper<PlummerLaw>;
+template class BasicMixedStepper<SplineLaw>;
+template class BasicMixedStepper<CoulombLaw>;
+
+void step_double(MixedBodies &b) {
+    size_t n = b.size();
+    double eps2 = (double)eps * eps;
+    double gdt = (double)G * dt;
+    for (size_t i = 0; i < n; i++) {
+        double sx = 0, sy = 0, sz = 0;
+        for (size_t j = 0; j < n; j++) {
+            double dx = b.px[j] - b.px[i];
+            double dy = b.py[j] - b.py[i];
+            double dz = b.pz[j] - b.pz[i];
+            double d2 = dx * dx + dy * dy + dz * dz + eps2;
+            double f = b.mass[j] / (d2 * std::sqrt(d2));
+            sx += dx * f;
+            sy += dy * f;
+            sz += dz * f;
+        }
+        b.vx[i] += sx * gdt;
+        b.vy[i] += sy * gdt;
+        b.vz[i] += sz * gdt;
+    }
+    for (size_t i = 0; i < n; i++) {
+        b.px[i] += b.vx[i] * dt;
+        b.py[i] += b.vy[i] * dt;
+        b.pz[i] += b.vz[i] * dt;
+    }
+}
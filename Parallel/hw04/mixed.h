@@ -0,0 +1,51 @@
+#pragma once
+#include "nbody.h"
+#include "pool.h"
+#include "force_law.h"
+#include <vector>
+
+// 位置、速度以 double 保存的状态
+struct MixedBodies {
+    std::vector<double> px, py, pz;
+    std::vector<double> vx, vy, vz;
+    std::vector<float> mass;
+
+    size_t size() const noexcept {
+        return px.size();
+    }
+
+    static MixedBodies from(Bodies const &b);
+    void store(Bodies &b) const;
+};
+
+// 混合精度的 step()：每步把位置换成相对某个格点原点的 float 偏移，
+// 成对的力在 float SIMD 里算，每块源粒子的部分和再累加到 double（或补偿 float）里
+// Law 是编译期的力律策略（force_law.h），实现在 mixed.cpp 里对各个力律显式实例化
+template <class Law>
+class BasicMixedStepper {
+public:
+    enum Accumulation { Double, Compensated };
+
+    // 块长按 N 取，至少分成 8 块左右，夹在 [kMinBlock, kBlock] 之间：只有一块时两种累加方式都退化成纯 float；
+    // 块太短则每块的 double 累加和 SIMD 归约开销压过成对计算（N = 4096 时 16 比 256 慢约 3 倍）
+    static constexpr size_t kMinBlock = 16;
+    static constexpr size_t kBlock = 256;
+
+    BasicMixedStepper(WorkStealingPool &pool, Accumulation acc = Double);
+
+    void step(MixedBodies &b);
+
+private:
+    template <Accumulation Acc>
+    void kick(MixedBodies &b, size_t begin, size_t end, size_t block);
+
+    WorkStealingPool &m_pool;
+    Accumulation m_acc;
+    std::vector<float> m_ox, m_oy, m_oz;
+};
+
+using MixedStepper = BasicMixedStepper<PlummerLaw>;
+
+// 全 double 的参考实现，用来对比能量漂移
+// 只有 Plummer 软化：force_law.h 的力律都是 float 的，double 参考要单独写一份
+void step_double(MixedBodies &b);
@@ -0,0 +1,94 @@
+#include "morton.h"
+#include <algorithm>
+#include <cmath>
+
+SpatialSorter::SpatialSorter(WorkStealingPool &pool) : m_pool(pool) {
+}
+
+void SpatialSorter::compute_keys(Bodies const &b) {
+    size_t n = b.size();
+    m_keys.resize(n);
+    m_index.resize(n);
+    if (n == 0) // 空区间上 minmax_element 返回 end()，不能解引用
+        return;
+    float lo[3] = {INFINITY, INFINITY, INFINITY}, hi[3] = {-INFINITY, -INFINITY, -INFINITY};
+    std::vector<float> const *pos[3] = {&b.px, &b.py, &b.pz};
+    for (int a = 0; a < 3; a++) {
+        auto [mn, mx] = std::minmax_element(pos[a]->begin(), pos[a]->end());
+        lo[a] = *mn;
+        hi[a] = *mx;
+    }
+    float scale[3];
+    for (int a = 0; a < 3; a++)
+        scale[a] = hi[a] > lo[a] ? 0x1FFFFF / (hi[a] - lo[a]) : 0;
+    m_pool.parallel_for(n, 16384, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; i++) {
+            uint32_t ix = (b.px[i] - lo[0]) * scale[0];
+            uint32_t iy = (b.py[i] - lo[1]) * scale[1];
+            uint32_t iz = (b.pz[i] - lo[2]) * scale[2];
+            m_keys[i] = morton_key(ix, iy, iz);
+            m_index[i] = i;
+        }
+    });
+}
+
+// 每轮 8 位：各块并行统计直方图，按 (桶, 块) 的顺序做前缀和，再各块并行稳定地分发
+void SpatialSorter::radix_sort() {
+    size_t n = m_keys.size();
+    size_t nblocks = std::max<size_t>(1, std::min<size_t>(m_pool.size() * 4, n / 4096));
+    m_keys_tmp.resize(n);
+    m_index_tmp.resize(n);
+    m_hist.resize(nblocks * 256);
+    for (int shift = 0; shift < 63; shift += 8) {
+        std::fill(m_hist.begin(), m_hist.end(), 0);
+        m_pool.run(nblocks, [&](size_t k, unsigned) {
+            size_t *h = &m_hist[k * 256];
+            for (size_t i = n * k / nblocks; i < n * (k + 1) / nblocks; i++)
+                h[(m_keys[i] >> shift) & 0xFF]++;
+        });
+        // 所有键这一位都相同就不用搬了
+        bool trivial = false;
+        for (size_t d = 0; d < 256 && !trivial; d++) {
+            size_t total = 0;
+            for (size_t k = 0; k < nblocks; k++)
+                total += m_hist[k * 256 + d];
+            trivial = total == n;
+        }
+        if (trivial)
+            continue;
+        size_t sum = 0;
+        for (size_t d = 0; d < 256; d++) {
+            for (size_t k = 0; k < nblocks; k++) {
+                size_t c = m_hist[k * 256 + d];
+                m_hist[k * 256 + d] = sum;
+                sum += c;
+            }
+        }
+        m_pool.run(nblocks, [&](size_t k, unsigned) {
+            size_t *h = &m_hist[k * 256];
+            for (size_t i = n * k / nblocks; i < n * (k + 1) / nblocks; i++) {
+                size_t dst = h[(m_keys[i] >> shift) & 0xFF]++;
+                m_keys_tmp[dst] = m_keys[i];
+                m_index_tmp[dst] = m_index[i];
+            }
+        });
+        m_keys.swap(m_keys_tmp);
+        m_index.swap(m_index_tmp);
+    }
+}
+
+void SpatialSorter::permute(std::vector<float> &field) {
+    m_scratch.resize(field.size());
+    m_pool.parallel_for(field.size(), 16384, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; i++)
+            m_scratch[i] = field[m_index[i]];
+    });
+    field.swap(m_scratch);
+}
+
+void SpatialSorter::reorder(Bodies &b) {
+    compute_keys(b);
+    radix_sort();
+    for (auto *f: {&b.px, &b.py, &b.pz, &b.vx, &b.vy, &b.vz, &b.mass})
+        permute(*f);
+}
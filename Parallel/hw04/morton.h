@@ -0,0 +1,45 @@
+#pragma once
+#include "nbody.h"
+#include "pool.h"
+#include <cstdint>
+#include <vector>
+
+// 把 21 位整数的各位隔两位摊开，三个轴交错成 63 位 Morton 键
+inline uint64_t spread_bits(uint64_t v) {
+    v &= 0x1FFFFF;
+    v = (v | v << 32) & 0x001F00000000FFFFull;
+    v = (v | v << 16) & 0x001F0000FF0000FFull;
+    v = (v | v << 8) & 0x100F00F00F00F00Full;
+    v = (v | v << 4) & 0x10C30C30C30C30C3ull;
+    v = (v | v << 2) & 0x1249249249249249ull;
+    return v;
+}
+
+inline uint64_t morton_key(uint32_t ix, uint32_t iy, uint32_t iz) {
+    return spread_bits(ix) | spread_bits(iy) << 1 | spread_bits(iz) << 2;
+}
+
+// 按 Morton 曲线重排粒子：并行算键、并行 LSD 基数排序，再把所有 SoA 字段一起按排列搬动
+// 空间上相邻的粒子在内存里也相邻，每隔几步跑一次即可
+class SpatialSorter {
+public:
+    explicit SpatialSorter(WorkStealingPool &pool);
+
+    void reorder(Bodies &b);
+
+    // 重排后第 i 个粒子原来的下标
+    std::vector<uint32_t> const &permutation() const noexcept {
+        return m_index;
+    }
+
+private:
+    void compute_keys(Bodies const &b);
+    void radix_sort();
+    void permute(std::vector<float> &field);
+
+    WorkStealingPool &m_pool;
+    std::vector<uint64_t> m_keys, m_keys_tmp;
+    std::vector<uint32_t> m_index, m_index_tmp;
+    std::vector<size_t> m_hist; // [块][桶]
+    std::vector<float> m_scratch;
+};
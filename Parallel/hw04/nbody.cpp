@@ -0,0 +1,97 @@
+#include "nbody.h"
+#include "initial.h"
+#include <cmath>
+
+std::vector<Star> stars;
+
+void init() {
+    to_stars(uniform_cube(48, 0), stars);
+}
+
+float G = 0.001;
+float eps = 0.001;
+float dt = 0.01;
+
+void step() {
+    for (auto &star: stars) {
+        for (auto &other: stars) {
+            float dx = other.px - star.px;
+            float dy = other.py - star.py;
+            float dz = other.pz - star.pz;
+            float d2 = dx * dx + dy * dy + dz * dz + eps * eps;
+            d2 *= sqrt(d2);
+            star.vx += dx * other.mass * G * dt / d2;
+            star.vy += dy * other.mass * G * dt / d2;
+            star.vz += dz * other.mass * G * dt / d2;
+        }
+    }
+    for (auto &star: stars) {
+        star.px += star.vx * dt;
+        star.py += star.vy * dt;
+        star.pz += star.vz * dt;
+    }
+}
+
+float calc() {
+    float energy = 0;
+    for (auto &star: stars) {
+        float v2 = star.vx * star.vx + star.vy * star.vy + star.vz * star.vz;
+        energy += star.mass * v2 / 2;
+        for (auto &other: stars) {
+            float dx = other.px - star.px;
+            float dy = other.py - star.py;
+            float dz = other.pz - star.pz;
+            float d2 = dx * dx + dy * dy + dz * dz + eps * eps;
+            energy -= other.mass * star.mass * G / sqrt(d2) / 2;
+        }
+    }
+    return energy;
+}
+
+void Bodies::resize(size_t n) {
+    for (auto *f: {&px, &py, &pz, &vx, &vy, &vz, &mass})
+        f->resize(n);
+}
+
+Bodies make_bodies(size_t n, uint64_t seed) {
+    return uniform_cube(n, seed);
+}
+
+Bodies to_bodies(std::vector<Star> const &stars) {
+    Bodies b;
+    b.resize(stars.size());
+    for (size_t i = 0; i < stars.size(); i++) {
+        auto const &s = stars[i];
+        b.px[i] = s.px; b.py[i] = s.py; b.pz[i] = s.pz;
+        b.vx[i] = s.vx; b.vy[i] = s.vy; b.vz[i] = s.vz;
+        b.mass[i] = s.mass;
+    }
+    return b;
+}
+
+void to_stars(Bodies const &b, std::vector<Star> &stars) {
+    stars.resize(b.size());
+    for (size_t i = 0; i < b.size(); i++) {
+        stars[i] = {b.px[i], b.py[i], b.pz[i],
+                    b.vx[i], b.vy[i], b.vz[i], b.mass[i]};
+    }
+}
+
+double energy(Bodies const &b) {
+    size_t n = b.size();
+    double e2 = (double)eps * eps;
+    double kin = 0, pot = 0;
+    for (size_t i = 0; i < n; i++) {
+        double v2 = (double)b.vx[i] * b.vx[i] + (double)b.vy[i] * b.vy[i] + (double)b.vz[i] * b.vz[i];
+        kin += b.mass[i] * v2 / 2;
+        double row = 0;
+        for (size_t j = 0; j < n; j++) {
+            double dx = (double)b.px[j] - b.px[i];
+            double dy = (double)b.py[j] - b.py[i];
+            double dz = (double)b.pz[j] - b.pz[i];
+            row += b.mass[j] / std::sqrt(dx * dx + dy * dy + dz * dz + e2);
+        }
+        pot -= row * b.mass[i] * G / 2;
+    }
+    return kin + pot;
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct Star {
+    float px, py, pz;
+    float vx, vy, vz;
+    float mass;
+};
+
+extern std::vector<Star> stars;
+extern float G;
+extern float eps;
+extern float dt;
+
+void init();
+void step();
+float calc();
+
+// SoA 布局，并行/向量化的内核都在这上面跑
+struct Bodies {
+    std::vector<float> px, py, pz;
+    std::vector<float> vx, vy, vz;
+    std::vector<float> mass;
+
+    size_t size() const noexcept {
+        return px.size();
+    }
+
+    void resize(size_t n);
+};
+
+Bodies make_bodies(size_t n, uint64_t seed = 0); // 和 init() 相同的分布
+Bodies to_bodies(std::vector<Star> const &stars);
+void to_stars(Bodies const &b, std::vector<Star> &stars);
+double energy(Bodies const &b); // 与 calc() 同一公式，双精度累加
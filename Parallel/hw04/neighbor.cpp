@@ -0,0 +1,229 @@
+#include "neighbor.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+double ms_since(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+}
+
+template <class Law>
+BasicNeighborStepper<Law>::BasicNeighborStepper(WorkStealingPool &pool, float cutoff, float skin, bool reorder)
+    : m_pool(pool), m_cutoff(cutoff), m_skin(skin), m_reorder(reorder), m_sorter(pool) {
+}
+
+template <class Law>
+bool BasicNeighborStepper<Law>::need_rebuild(Bodies const &b) {
+    if (m_x0.size() != b.size())
+        return true;
+    float limit = m_skin * m_skin / 4;
+    size_t n = b.size();
+    std::vector<char> moved((n + 16383) / 16384, 0);
+    m_pool.parallel_for(n, 16384, [&](size_t begin, size_t end, unsigned) {
+        float worst = 0;
+        for (size_t i = begin; i < end; i++) {
+            float dx = b.px[i] - m_x0[i], dy = b.py[i] - m_y0[i], dz = b.pz[i] - m_z0[i];
+            worst = std::max(worst, dx * dx + dy * dy + dz * dz);
+        }
+        moved[begin / 16384] = worst > limit;
+    });
+    return std::find(moved.begin(), moved.end(), 1) != moved.end();
+}
+
+// 并行计数排序：每块统计各格子的粒子数，按 (格子, 块) 顺序前缀和，再各块稳定地分发
+template <class Law>
+void BasicNeighborStepper<Law>::build_cells(Bodies const &b) {
+    size_t n = b.size();
+    if (n == 0) {
+        for (int a = 0; a < 3; a++) {
+            m_lo[a] = 0;
+            m_inv_cell[a] = 0;
+            m_dim[a] = 1;
+        }
+        m_cell_of.clear();
+        m_cell_start.assign(2, 0);
+        m_cell_items.clear();
+        m_cx.clear();
+        m_cy.clear();
+        m_cz.clear();
+        return;
+    }
+    float hi[3];
+    std::vector<float> const *pos[3] = {&b.px, &b.py, &b.pz};
+    for (int a = 0; a < 3; a++) {
+        auto [mn, mx] = std::minmax_element(pos[a]->begin(), pos[a]->end());
+        m_lo[a] = *mn;
+        hi[a] = *mx;
+    }
+    // 每轴最多 (4n)^(1/3) 格，总格数不超过 4n 左右：一个离群很远的粒子不会让网格（和直方图）爆掉
+    // 被限制的轴格子边长大于 cutoff + skin，只扫相邻格子照样不漏，只是候选多一些
+    float cell = m_cutoff + m_skin;
+    int limit = std::max(1, (int)std::cbrt(4.0 * n));
+    size_t ncells = 1;
+    for (int a = 0; a < 3; a++) {
+        double extent = (double)hi[a] - m_lo[a];
+        double want = std::floor(extent / cell) + 1;
+        m_dim[a] = want < limit ? std::max(1, (int)want) : limit;
+        m_inv_cell[a] = m_dim[a] == limit && extent > 0 ? std::min(1 / cell, (float)(m_dim[a] / extent)) : 1 / cell;
+        ncells *= (size_t)m_dim[a];
+    }
+    m_cell_of.resize(n);
+    size_t nblocks = std::max<size_t>(1, std::min<size_t>(m_pool.size() * 4, n / 16384));
+    m_hist.assign(nblocks * ncells, 0);
+    m_pool.run(nblocks, [&](size_t k, unsigned) {
+        size_t *h = &m_hist[k * ncells];
+        for (size_t i = n * k / nblocks; i < n * (k + 1) / nblocks; i++) {
+            int cx = std::min(m_dim[0] - 1, (int)((b.px[i] - m_lo[0]) * m_inv_cell[0]));
+            int cy = std::min(m_dim[1] - 1, (int)((b.py[i] - m_lo[1]) * m_inv_cell[1]));
+            int cz = std::min(m_dim[2] - 1, (int)((b.pz[i] - m_lo[2]) * m_inv_cell[2]));
+            size_t c = ((size_t)cz * m_dim[1] + cy) * m_dim[0] + cx;
+            m_cell_of[i] = (uint32_t)c;
+            h[c]++;
+        }
+    });
+    m_cell_start.assign(ncells + 1, 0);
+    size_t sum = 0;
+    for (size_t c = 0; c < ncells; c++) {
+        m_cell_start[c] = sum;
+        for (size_t k = 0; k < nblocks; k++) {
+            size_t cnt = m_hist[k * ncells + c];
+            m_hist[k * ncells + c] = sum;
+            sum += cnt;
+        }
+    }
+    m_cell_start[ncells] = sum;
+    m_cell_items.resize(n);
+    m_cx.resize(n);
+    m_cy.resize(n);
+    m_cz.resize(n);
+    m_pool.run(nblocks, [&](size_t k, unsigned) {
+        size_t *h = &m_hist[k * ncells];
+        for (size_t i = n * k / nblocks; i < n * (k + 1) / nblocks; i++) {
+            size_t dst = h[m_cell_of[i]]++;
+            m_cell_items[dst] = i;
+            m_cx[dst] = b.px[i];
+            m_cy[dst] = b.py[i];
+            m_cz[dst] = b.pz[i];
+        }
+    });
+}
+
+// 每块粒子先把近邻写进自己的临时表，同时记下个数；前缀和得到 CSR 偏移后再并行拷贝到一起
+template <class Law>
+void BasicNeighborStepper<Law>::build_list(Bodies const &b) {
+    size_t n = b.size();
+    constexpr size_t grain = 4096;
+    float r2max = (m_cutoff + m_skin) * (m_cutoff + m_skin);
+    m_offsets.assign(n + 1, 0);
+    m_chunk_lists.resize((n + grain - 1) / grain);
+    m_pool.parallel_for(n, grain, [&](size_t begin, size_t end, unsigned) {
+        auto &list = m_chunk_lists[begin / grain];
+        list.clear();
+        for (size_t i = begin; i < end; i++) {
+            float xi = b.px[i], yi = b.py[i], zi = b.pz[i];
+            uint32_t c = m_cell_of[i];
+            int cx = c % m_dim[0], cy = c / m_dim[0] % m_dim[1], cz = c / m_dim[0] / m_dim[1];
+            size_t before = list.size();
+            for (int z = std::max(0, cz - 1); z <= std::min(m_dim[2] - 1, cz + 1); z++) {
+                for (int y = std::max(0, cy - 1); y <= std::min(m_dim[1] - 1, cy + 1); y++) {
+                    // 同一行里相邻的三个格子在 m_cell_items 中是连续的一段
+                    size_t row = ((size_t)z * m_dim[1] + y) * m_dim[0];
+                    size_t k0 = m_cell_start[row + std::max(0, cx - 1)];
+                    size_t k1 = m_cell_start[row + std::min(m_dim[0] - 1, cx + 1) + 1];
+                    for (size_t k = k0; k < k1; k++) {
+                        float dx = m_cx[k] - xi, dy = m_cy[k] - yi, dz = m_cz[k] - zi;
+                        if (dx * dx + dy * dy + dz * dz < r2max && m_cell_items[k] != i)
+                            list.push_back(m_cell_items[k]);
+                    }
+                }
+            }
+            m_offsets[i + 1] = list.size() - before;
+        }
+    });
+    for (size_t i = 0; i < n; i++)
+        m_offsets[i + 1] += m_offsets[i];
+    m_neighbors.resize(m_offsets[n]);
+    m_pool.run(m_chunk_lists.size(), [&](size_t c, unsigned) {
+        auto const &list = m_chunk_lists[c];
+        std::copy(list.begin(), list.end(), m_neighbors.begin() + m_offsets[c * grain]);
+    });
+}
+
+template <class Law>
+void BasicNeighborStepper<Law>::rebuild(Bodies &b) {
+    auto t0 = std::chrono::steady_clock::now();
+    // 重排只能在重建时做，否则旧表里的下标就失效了
+    if (m_reorder) {
+        size_t n = b.size();
+        if (m_order.size() != n) {
+            m_order.resize(n);
+            for (size_t i = 0; i < n; i++)
+                m_order[i] = i;
+        }
+        m_sorter.reorder(b);
+        // 和之前的重排复合起来，m_order 始终相对调用者最初的下标
+        auto const &perm = m_sorter.permutation();
+        std::vector<uint32_t> order(n);
+        for (size_t i = 0; i < n; i++)
+            order[i] = m_order[perm[i]];
+        m_order.swap(order);
+    }
+    build_cells(b);
+    build_list(b);
+    m_x0 = b.px;
+    m_y0 = b.py;
+    m_z0 = b.pz;
+    m_rebuilds++;
+    m_rebuild_ms += ms_since(t0);
+}
+
+template <class Law>
+void BasicNeighborStepper<Law>::step(Bodies &b) {
+    if (need_rebuild(b))
+        rebuild(b);
+    auto t0 = std::chrono::steady_clock::now();
+    size_t n = b.size();
+    float const *px = b.px.data(), *py = b.py.data(), *pz = b.pz.data();
+    float const *m = b.mass.data();
+    uint32_t const *nb = m_neighbors.data();
+    Law const law(eps);
+    float rc2 = m_cutoff * m_cutoff;
+    float gdt = G * dt;
+    m_pool.parallel_for(n, 1024, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; i++) {
+            float xi = px[i], yi = py[i], zi = pz[i];
+            float sx = 0, sy = 0, sz = 0;
+#pragma omp simd reduction(+:sx, sy, sz)
+            for (size_t k = m_offsets[i]; k < m_offsets[i + 1]; k++) {
+                uint32_t j = nb[k];
+                float dx = px[j] - xi;
+                float dy = py[j] - yi;
+                float dz = pz[j] - zi;
+                float r2 = dx * dx + dy * dy + dz * dz;
+                float f = r2 < rc2 ? m[j] * law.force(r2) : 0.0f;
+                sx += dx * f;
+                sy += dy * f;
+                sz += dz * f;
+            }
+            b.vx[i] += sx * gdt;
+            b.vy[i] += sy * gdt;
+            b.vz[i] += sz * gdt;
+        }
+    });
+    m_pool.parallel_for(n, 16384, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; i++) {
+            b.px[i] += b.vx[i] * dt;
+            b.py[i] += b.vy[i] * dt;
+            b.pz[i] += b.vz[i] * dt;
+        }
+    });
+    m_force_ms += ms_since(t0);
+}
+
+template class BasicNeighborStepper<PlummerLaw>;
+template class BasicNeighborStepper<SplineLaw>;
+template class BasicNeighborStepper<CoulombLaw>;
@@ -0,0 +1,63 @@
+#pragma once
+#include "nbody.h"
+#include "pool.h"
+#include "morton.h"
+#include "force_law.h"
+#include <cstdint>
+#include <vector>
+
+// 短程版 step()：力在 cutoff 处截断。
+// 先把粒子并行计数排序进均匀网格（格子边长 = cutoff + skin），再建带 skin 的 Verlet 近邻表（CSR），
+// 之后只要没有粒子走出 skin / 2 就一直复用这张表，成对循环只遍历紧凑的近邻数组
+// reorder 为 true 时每次重建前按 Morton 顺序重排 Bodies 本身：调用者手里的下标会失效，
+// 要用 order() 把现在的第 i 个粒子对回第一次 step() 时的下标
+// Law 是编译期的力律策略（force_law.h），截断只是套在 law.force(r2) 外面的掩码，
+// 实现在 neighbor.cpp 里对各个力律显式实例化
+template <class Law>
+class BasicNeighborStepper {
+public:
+    BasicNeighborStepper(WorkStealingPool &pool, float cutoff, float skin, bool reorder = false);
+
+    void step(Bodies &b);
+
+    size_t rebuilds() const noexcept { return m_rebuilds; }
+    size_t pairs() const noexcept { return m_neighbors.size(); }
+    double rebuild_ms() const noexcept { return m_rebuild_ms; }
+    double force_ms() const noexcept { return m_force_ms; }
+
+    // 现在的第 i 个粒子在第一次 step() 时的下标；reorder 为 false 或还没重排过时为空
+    std::vector<uint32_t> const &order() const noexcept { return m_order; }
+
+private:
+    bool need_rebuild(Bodies const &b);
+    void rebuild(Bodies &b);
+    void build_cells(Bodies const &b);
+    void build_list(Bodies const &b);
+
+    WorkStealingPool &m_pool;
+    float m_cutoff, m_skin;
+    bool m_reorder;
+    SpatialSorter m_sorter;
+
+    // 网格：m_cell_start[c] .. m_cell_start[c + 1] 是第 c 格里的粒子在 m_cell_items 中的范围
+    float m_lo[3];
+    float m_inv_cell[3];
+    int m_dim[3];
+    std::vector<uint32_t> m_cell_of;
+    std::vector<size_t> m_cell_start;
+    std::vector<uint32_t> m_cell_items;
+    std::vector<float> m_cx, m_cy, m_cz; // 按格子顺序排好的位置副本，扫描邻格时是连续读
+    std::vector<size_t> m_hist;
+
+    // Verlet 表：m_offsets[i] .. m_offsets[i + 1] 是 i 的近邻
+    std::vector<size_t> m_offsets;
+    std::vector<uint32_t> m_neighbors;
+    std::vector<std::vector<uint32_t>> m_chunk_lists;
+    std::vector<float> m_x0, m_y0, m_z0;
+    std::vector<uint32_t> m_order;
+
+    size_t m_rebuilds = 0;
+    double m_rebuild_ms = 0, m_force_ms = 0;
+};
+
+using NeighborStepper = BasicNeighborStepper<PlummerLaw>;
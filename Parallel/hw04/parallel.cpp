@@ -0,0 +1,194 @@
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Kahan 补偿求和，块内逐行累加用
+struct KahanSum {
+    double sum = 0, c = 0;
+
+    void add(double x) {
+        double y = x - c;
+        double t = sum + y;
+        c = (t - sum) - y;
+        sum = t;
+    }
+};
+
+// 两两求和，误差 O(log n)，且顺序只取决于 n
+template <class Get>
+double pairwise_sum(size_t begin, size_t end, Get const &get) {
+    if (end - begin <= 8) {
+        double s = 0;
+        for (size_t i = begin; i < end; i++)
+            s += get(i);
+        return s;
+    }
+    size_t mid = begin + (end - begin) / 2;
+    return pairwise_sum(begin, mid, get) + pairwise_sum(mid, end, get);
+}
+
+}
+
+template <class Law>
+BasicParallelStepper<Law>::BasicParallelStepper(WorkStealingPool &pool, size_t tile)
+    : m_pool(pool), m_tile(tile ? tile : 1), m_acc(pool.size()) {
+}
+
+template <class Law>
+void BasicParallelStepper<Law>::prepare(size_t n) {
+    if (n == m_n)
+        return;
+    m_n = n;
+    size_t nb = (n + m_tile - 1) / m_tile;
+    m_blocks.clear();
+    for (size_t bi = 0; bi < nb; bi++)
+        for (size_t bj = bi; bj < nb; bj++)
+            m_blocks.emplace_back(bi, bj);
+    for (auto &acc: m_acc)
+        acc.assign(3 * n, 0.0f);
+    m_block_pot.assign(m_blocks.size(), 0.0);
+    m_chunk_diag.assign((n + kChunk - 1) / kChunk, {});
+    m_ax.assign(n, 0.0f);
+    m_ay.assign(n, 0.0f);
+    m_az.assign(n, 0.0f);
+}
+
+template <class Law>
+template <bool Diag>
+void BasicParallelStepper<Law>::pair_block(Bodies const &b, size_t k, unsigned tid) {
+    size_t bi = m_blocks[k].first, bj = m_blocks[k].second;
+    size_t n = b.size();
+    float *ax = m_acc[tid].data();
+    float *ay = ax + n;
+    float *az = ay + n;
+    float const *px = b.px.data(), *py = b.py.data(), *pz = b.pz.data();
+    float const *m = b.mass.data();
+    Law const law(eps);
+    size_t i0 = bi * m_tile, i1 = std::min(i0 + m_tile, n);
+    size_t j0 = bj * m_tile, j1 = std::min(j0 + m_tile, n);
+    KahanSum pot;
+    for (size_t i = i0; i < i1; i++) {
+        float xi = px[i], yi = py[i], zi = pz[i], mi = m[i];
+        float sx = 0, sy = 0, sz = 0, sp = 0;
+        size_t jb = bi == bj ? i + 1 : j0;
+#pragma omp simd reduction(+:sx, sy, sz, sp)
+        for (size_t j = jb; j < j1; j++) {
+            float dx = px[j] - xi;
+            float dy = py[j] - yi;
+            float dz = pz[j] - zi;
+            float r2 = dx * dx + dy * dy + dz * dz;
+            float inv = law.force(r2);
+            if constexpr (Diag)
+                sp += m[j] * law.potential(r2);
+            float fj = m[j] * inv;
+            float fi = mi * inv;
+            sx += dx * fj;
+            sy += dy * fj;
+            sz += dz * fj;
+            ax[j] -= dx * fi;
+            ay[j] -= dy * fi;
+            az[j] -= dz * fi;
+        }
+        ax[i] += sx;
+        ay[i] += sy;
+        az[i] += sz;
+        if constexpr (Diag) {
+            pot.add((double)sp * mi);
+            if (bi == bj) // calc() 里 i == j 那一项
+                pot.add((double)mi * mi * law.potential(0) / 2);
+        }
+    }
+    if constexpr (Diag)
+        m_block_pot[k] = -G * pot.sum;
+}
+
+// 按粒子分块归约各线程的缓冲（顺便清零）
+// 块是偷来偷去的，某对粒子的力落进哪个线程的缓冲每次运行都可能不同，
+// 所以即使线程数固定，力的浮点求和顺序也不固定，结果可能差最后几位；只有 Diagnostics 是确定的
+template <class Law>
+template <class Post>
+void BasicParallelStepper<Law>::reduce(size_t n, Post const &post) {
+    m_pool.parallel_for(n, kChunk, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; i++) {
+            float sx = 0, sy = 0, sz = 0;
+            for (auto &acc: m_acc) {
+                sx += acc[i];
+                sy += acc[n + i];
+                sz += acc[2 * n + i];
+                acc[i] = acc[n + i] = acc[2 * n + i] = 0;
+            }
+            post(i, sx, sy, sz);
+        }
+    });
+}
+
+template <class Law>
+void BasicParallelStepper<Law>::accelerate(Bodies const &b) {
+    size_t n = b.size();
+    prepare(n);
+    m_pool.run(m_blocks.size(), [&](size_t k, unsigned tid) {
+        pair_block<false>(b, k, tid);
+    });
+    reduce(n, [&](size_t i, float sx, float sy, float sz) {
+        m_ax[i] = sx;
+        m_ay[i] = sy;
+        m_az[i] = sz;
+    });
+}
+
+template <class Law>
+void BasicParallelStepper<Law>::step(Bodies &b, Diagnostics *diag) {
+    size_t n = b.size();
+    prepare(n);
+    if (diag) {
+        m_pool.run(m_blocks.size(), [&](size_t k, unsigned tid) {
+            pair_block<true>(b, k, tid);
+        });
+        // 动能、动量、角动量用 kick 之前的 v，和势能对应同一时刻
+        m_pool.parallel_for(n, kChunk, [&](size_t begin, size_t end, unsigned) {
+            Diagnostics d;
+            KahanSum kin;
+            for (size_t i = begin; i < end; i++) {
+                double m = b.mass[i];
+                double x = b.px[i], y = b.py[i], z = b.pz[i];
+                double vx = b.vx[i], vy = b.vy[i], vz = b.vz[i];
+                kin.add(m * (vx * vx + vy * vy + vz * vz) / 2);
+                d.momentum[0] += m * vx;
+                d.momentum[1] += m * vy;
+                d.momentum[2] += m * vz;
+                d.angular[0] += m * (y * vz - z * vy);
+                d.angular[1] += m * (z * vx - x * vz);
+                d.angular[2] += m * (x * vy - y * vx);
+            }
+            d.kinetic = kin.sum;
+            m_chunk_diag[begin / kChunk] = d;
+        });
+        auto const &cd = m_chunk_diag;
+        diag->potential = pairwise_sum(0, m_block_pot.size(), [&](size_t k) { return m_block_pot[k]; });
+        diag->kinetic = pairwise_sum(0, cd.size(), [&](size_t c) { return cd[c].kinetic; });
+        for (int a = 0; a < 3; a++) {
+            diag->momentum[a] = pairwise_sum(0, cd.size(), [&](size_t c) { return cd[c].momentum[a]; });
+            diag->angular[a] = pairwise_sum(0, cd.size(), [&](size_t c) { return cd[c].angular[a]; });
+        }
+    } else {
+        m_pool.run(m_blocks.size(), [&](size_t k, unsigned tid) {
+            pair_block<false>(b, k, tid);
+        });
+    }
+    float gdt = G * dt;
+    // 所有力都已算完，kick 和 drift 可以逐粒子合并在归约里做
+    reduce(n, [&](size_t i, float sx, float sy, float sz) {
+        b.vx[i] += sx * gdt;
+        b.vy[i] += sy * gdt;
+        b.vz[i] += sz * gdt;
+        b.px[i] += b.vx[i] * dt;
+        b.py[i] += b.vy[i] * dt;
+        b.pz[i] += b.vz[i] * dt;
+    });
+}
+
+template class BasicParallelStepper<PlummerLaw>;
+template class BasicParallelStepper<SplineLaw>;
+template class BasicParallelStepper<CoulombLaw>;
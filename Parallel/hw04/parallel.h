@@ -0,0 +1,57 @@
+#pragma once
+#include "nbody.h"
+#include "pool.h"
+#include "force_law.h"
+#include <utility>
+#include <vector>
+
+// 能量、动量、角动量，和 calc() 一样包含 i == j 的软化自能项
+struct Diagnostics {
+    double kinetic = 0, potential = 0;
+    double momentum[3] = {0, 0, 0};
+    double angular[3] = {0, 0, 0};
+
+    double energy() const noexcept {
+        return kinetic + potential;
+    }
+};
+
+// 多线程版 step()：相互作用矩阵切成 tile×tile 的块，只算上三角的块，
+// 每对粒子只算一次（牛顿第三定律），力先累加到每个线程私有的缓冲里，最后再归约
+// Law 是编译期的力律策略（force_law.h），实现在 parallel.cpp 里对各个力律显式实例化
+template <class Law>
+class BasicParallelStepper {
+public:
+    explicit BasicParallelStepper(WorkStealingPool &pool, size_t tile = 256);
+
+    // diag 非空时，顺便在同一遍里统计 step 开始时刻的 Diagnostics
+    // 部分和按块号/粒子段号存放再按固定顺序两两求和，结果与线程数和调度无关
+    void step(Bodies &b, Diagnostics *diag = nullptr);
+
+    // 只算加速度（未乘 G），结果在 ax()/ay()/az()
+    void accelerate(Bodies const &b);
+
+    std::vector<float> const &ax() const noexcept { return m_ax; }
+    std::vector<float> const &ay() const noexcept { return m_ay; }
+    std::vector<float> const &az() const noexcept { return m_az; }
+
+private:
+    void prepare(size_t n);
+    template <bool Diag>
+    void pair_block(Bodies const &b, size_t k, unsigned tid);
+    template <class Post>
+    void reduce(size_t n, Post const &post);
+
+    static constexpr size_t kChunk = 4096;
+
+    WorkStealingPool &m_pool;
+    size_t m_tile;
+    size_t m_n = 0;
+    std::vector<std::pair<size_t, size_t>> m_blocks;
+    std::vector<std::vector<float>> m_acc; // 每线程 [ax | ay | az]
+    std::vector<float> m_ax, m_ay, m_az;
+    std::vector<double> m_block_pot;
+    std::vector<Diagnostics> m_chunk_diag;
+};
+
+using ParallelStepper = BasicParallelStepper<PlummerLaw>;
@@ -0,0 +1,92 @@
+#include "pool.h"
+
+WorkStealingPool::WorkStealingPool(unsigned nthreads)
+    : m_nthreads(nthreads ? nthreads : 1), m_queues(new Queue[m_nthreads]) {
+    for (unsigned t = 1; t < m_nthreads; t++)
+        m_threads.emplace_back([this, t] { worker(t); });
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard lck(m_mtx);
+        m_stop = true;
+    }
+    m_cv_start.notify_all();
+    for (auto &t: m_threads)
+        t.join();
+}
+
+void WorkStealingPool::run(size_t ntasks, std::function<void(size_t, unsigned)> const &func) {
+    if (ntasks == 0)
+        return;
+    // 初始按连续区间平分，相邻任务留在同一线程上，对缓存友好
+    for (unsigned t = 0; t < m_nthreads; t++) {
+        std::lock_guard lck(m_queues[t].mtx);
+        m_queues[t].lo = ntasks * t / m_nthreads;
+        m_queues[t].hi = ntasks * (t + 1) / m_nthreads;
+    }
+    if (m_nthreads == 1) {
+        for (size_t i = 0; i < ntasks; i++)
+            func(i, 0);
+        m_queues[0].lo = ntasks;
+        return;
+    }
+    {
+        std::lock_guard lck(m_mtx);
+        m_func = &func;
+        m_running = m_nthreads - 1;
+        m_generation++;
+    }
+    m_cv_start.notify_all();
+    work(0);
+    std::unique_lock lck(m_mtx);
+    m_cv_done.wait(lck, [&] { return m_running == 0; });
+    m_func = nullptr;
+}
+
+bool WorkStealingPool::pop(unsigned tid, size_t &task) {
+    auto &q = m_queues[tid];
+    std::lock_guard lck(q.mtx);
+    if (q.lo == q.hi)
+        return false;
+    task = q.lo++;
+    return true;
+}
+
+bool WorkStealingPool::steal(unsigned tid, size_t &task) {
+    for (unsigned k = 1; k < m_nthreads; k++) {
+        auto &q = m_queues[(tid + k) % m_nthreads];
+        std::lock_guard lck(q.mtx);
+        if (q.lo != q.hi) {
+            task = --q.hi;
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingPool::work(unsigned tid) {
+    auto const &func = *m_func;
+    size_t task;
+    while (pop(tid, task) || steal(tid, task))
+        func(task, tid);
+}
+
+void WorkStealingPool::worker(unsigned tid) {
+    size_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock lck(m_mtx);
+            m_cv_start.wait(lck, [&] { return m_stop || m_generation != seen; });
+            if (m_stop)
+                return;
+            seen = m_generation;
+        }
+        work(tid);
+        {
+            std::lock_guard lck(m_mtx);
+            if (--m_running == 0)
+                m_cv_done.notify_one();
+        }
+    }
+}
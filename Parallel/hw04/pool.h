@@ -0,0 +1,63 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 常驻线程池：每个线程有自己的任务区间，自己从头部取，空闲时从别人的尾部偷
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(unsigned nthreads);
+    ~WorkStealingPool();
+
+    WorkStealingPool(WorkStealingPool const &) = delete;
+    WorkStealingPool &operator=(WorkStealingPool const &) = delete;
+
+    unsigned size() const noexcept {
+        return m_nthreads;
+    }
+
+    // 执行 func(task, tid)，task 取遍 [0, ntasks)，tid 在 [0, size()) 内
+    // 调用线程自己作为 tid 0 参与计算，返回时所有任务都已完成
+    void run(size_t ntasks, std::function<void(size_t, unsigned)> const &func);
+
+    // 把 [0, n) 切成大小为 grain 的块，执行 func(begin, end, tid)
+    template <class Func>
+    void parallel_for(size_t n, size_t grain, Func const &func) {
+        if (grain == 0)
+            grain = 1;
+        size_t nchunks = (n + grain - 1) / grain;
+        run(nchunks, [&](size_t c, unsigned tid) {
+            size_t begin = c * grain;
+            size_t end = begin + grain < n ? begin + grain : n;
+            func(begin, end, tid);
+        });
+    }
+
+private:
+    struct alignas(64) Queue {
+        std::mutex mtx;
+        size_t lo = 0, hi = 0;
+    };
+
+    bool pop(unsigned tid, size_t &task);
+    bool steal(unsigned tid, size_t &task);
+    void work(unsigned tid);
+    void worker(unsigned tid);
+
+    unsigned m_nthreads;
+    std::unique_ptr<Queue[]> m_queues;
+    std::vector<std::thread> m_threads;
+    std::function<void(size_t, unsigned)> const *m_func = nullptr;
+
+    std::mutex m_mtx;
+    std::condition_variable m_cv_start;
+    std::condition_variable m_cv_done;
+    size_t m_generation = 0;
+    unsigned m_running = 0;
+    bool m_stop = false;
+};
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+
+// 计数器式 RNG（SplitMix64 的混合函数）：结果只由 (seed, stream, counter) 决定，
+// 没有全局状态，第 i 个粒子用 stream = i，就可以任意顺序、任意线程数并行生成
+inline uint64_t splitmix64(uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+inline uint64_t counter_rng(uint64_t seed, uint64_t stream, uint64_t counter) {
+    uint64_t key = splitmix64(seed * 0x9E3779B97F4A7C15ull + stream);
+    return splitmix64(key + (counter + 1) * 0x9E3779B97F4A7C15ull);
+}
+
+// [0, 1) 上的均匀分布，取高 24 位正好填满 float 的尾数
+inline float uniform01(uint64_t seed, uint64_t stream, uint64_t counter) {
+    return (counter_rng(seed, stream, counter) >> 40) * (1.0f / (1 << 24));
+}
+
+// [-1, 1) 上的均匀分布，代替原来基于 rand() 的 frand()
+inline float frand(uint64_t seed, uint64_t stream, uint64_t counter) {
+    return uniform01(seed, stream, counter) * 2 - 1;
+}
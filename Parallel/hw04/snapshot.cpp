@@ -0,0 +1,233 @@
+#include "snapshot.h"
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NBODY_HAS_MMAP 1
+#endif
+
+namespace {
+
+constexpr char kMagic[8] = {'N', 'B', 'O', 'D', 'Y', 'S', 'N', 'P'};
+constexpr uint64_t kAlign = 64;
+
+uint64_t align_up(uint64_t x) {
+    return (x + kAlign - 1) / kAlign * kAlign;
+}
+
+struct Column {
+    char const *name;
+    std::vector<float> Bodies::*field;
+};
+
+constexpr Column kColumns[] = {
+    {"px", &Bodies::px}, {"py", &Bodies::py}, {"pz", &Bodies::pz},
+    {"vx", &Bodies::vx}, {"vy", &Bodies::vy}, {"vz", &Bodies::vz},
+    {"mass", &Bodies::mass},
+};
+constexpr uint32_t kNumColumns = sizeof(kColumns) / sizeof(kColumns[0]);
+
+// 从内存中的整个文件解析，fread 和 mmap 两条路径共用
+Bodies parse(unsigned char const *data, size_t size, uint64_t *step, double *time) {
+    SnapshotHeader h;
+    if (size < sizeof h)
+        throw std::runtime_error("snapshot: file too short");
+    memcpy(&h, data, sizeof h);
+    if (memcmp(h.magic, kMagic, sizeof kMagic) != 0)
+        throw std::runtime_error("snapshot: bad magic");
+    if (h.version != kSnapshotVersion)
+        throw std::runtime_error("snapshot: unsupported version " + std::to_string(h.version));
+    if (sizeof h + h.nfields * sizeof(SnapshotField) > size)
+        throw std::runtime_error("snapshot: truncated field table");
+    // 先用文件大小卡住 nbodies，坏掉的头不会导致巨大的分配，后面的乘法也不会溢出
+    if (h.nbodies > size / sizeof(float))
+        throw std::runtime_error("snapshot: body count exceeds file size");
+    uint64_t bytes = h.nbodies * sizeof(float);
+    Bodies b;
+    b.resize(h.nbodies);
+    bool found[kNumColumns] = {};
+    for (uint32_t f = 0; f < h.nfields; f++) {
+        SnapshotField fd;
+        memcpy(&fd, data + sizeof h + f * sizeof fd, sizeof fd);
+        for (uint32_t k = 0; k < kNumColumns; k++) {
+            auto const &c = kColumns[k];
+            if (strncmp(fd.name, c.name, sizeof fd.name) != 0)
+                continue;
+            if (fd.type != 0 || fd.offset > size || bytes > size - fd.offset)
+                throw std::runtime_error("snapshot: bad column " + std::string(c.name));
+            memcpy((b.*c.field).data(), data + fd.offset, bytes);
+            found[k] = true;
+        }
+    }
+    // 位置、速度、质量缺一列都没法接着积分，不能悄悄补零
+    for (uint32_t k = 0; k < kNumColumns; k++) {
+        if (!found[k])
+            throw std::runtime_error("snapshot: missing column " + std::string(kColumns[k].name));
+    }
+    if (step)
+        *step = h.step;
+    if (time)
+        *time = h.time;
+    return b;
+}
+
+}
+
+void write_snapshot(std::string const &path, Bodies const &b, uint64_t step, double time) {
+    SnapshotHeader h{};
+    memcpy(h.magic, kMagic, sizeof kMagic);
+    h.version = kSnapshotVersion;
+    h.nfields = kNumColumns;
+    h.nbodies = b.size();
+    h.step = step;
+    h.time = time;
+    SnapshotField fields[kNumColumns] = {};
+    uint64_t offset = align_up(sizeof h + sizeof fields);
+    for (uint32_t f = 0; f < kNumColumns; f++) {
+        strncpy(fields[f].name, kColumns[f].name, sizeof fields[f].name);
+        fields[f].offset = offset;
+        offset = align_up(offset + b.size() * sizeof(float));
+    }
+
+    // 先写临时文件再改名，崩溃时不会留下写了一半的快照
+    std::string tmp = path + ".tmp";
+    FILE *fp = fopen(tmp.c_str(), "wb");
+    if (!fp)
+        throw std::runtime_error("snapshot: cannot open " + tmp);
+    static char const zeros[kAlign] = {};
+    bool ok = fwrite(&h, sizeof h, 1, fp) == 1 && fwrite(fields, sizeof fields, 1, fp) == 1;
+    uint64_t pos = sizeof h + sizeof fields;
+    for (uint32_t f = 0; ok && f < kNumColumns; f++) {
+        ok = fwrite(zeros, 1, fields[f].offset - pos, fp) == fields[f].offset - pos;
+        auto const &col = b.*kColumns[f].field;
+        ok = ok && fwrite(col.data(), sizeof(float), col.size(), fp) == col.size();
+        pos = fields[f].offset + col.size() * sizeof(float);
+    }
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok || rename(tmp.c_str(), path.c_str()) != 0)
+        throw std::runtime_error("snapshot: failed writing " + path);
+}
+
+Bodies load_snapshot(std::string const &path, uint64_t *step, double *time, bool use_mmap) {
+#ifdef NBODY_HAS_MMAP
+    if (use_mmap) {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("snapshot: cannot open " + path);
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) {
+            close(fd);
+            throw std::runtime_error("snapshot: cannot stat " + path);
+        }
+        void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED)
+            throw std::runtime_error("snapshot: mmap failed for " + path);
+        madvise(p, st.st_size, MADV_SEQUENTIAL);
+        try {
+            Bodies b = parse((unsigned char const *)p, st.st_size, step, time);
+            munmap(p, st.st_size);
+            return b;
+        } catch (...) {
+            munmap(p, st.st_size);
+            throw;
+        }
+    }
+#else
+    (void)use_mmap;
+#endif
+    FILE *fp = fopen(path.c_str(), "rb");
+    if (!fp)
+        throw std::runtime_error("snapshot: cannot open " + path);
+    std::vector<unsigned char> data;
+    unsigned char buf[1 << 16];
+    size_t got;
+    while ((got = fread(buf, 1, sizeof buf, fp)) > 0)
+        data.insert(data.end(), buf, buf + got);
+    fclose(fp);
+    return parse(data.data(), data.size(), step, time);
+}
+
+SnapshotWriter::SnapshotWriter(std::string prefix)
+    : m_prefix(std::move(prefix)), m_thread([this] { worker(); }) {
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    {
+        std::unique_lock lck(m_mtx);
+        m_cv.wait(lck, [&] { return !m_pending && !m_busy; });
+    }
+    // 析构函数里不能抛，没人 flush() 取走的错误只能打出来
+    if (m_error) {
+        try {
+            std::rethrow_exception(m_error);
+        } catch (std::exception const &e) {
+            fprintf(stderr, "%s\n", e.what());
+        }
+    }
+    {
+        std::lock_guard lck(m_mtx);
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_thread.join();
+}
+
+std::string SnapshotWriter::path_for(uint64_t step) const {
+    char buf[32];
+    snprintf(buf, sizeof buf, "_%010llu.snap", (unsigned long long)step);
+    return m_prefix + buf;
+}
+
+void SnapshotWriter::submit(Bodies const &b, uint64_t step, double time) {
+    std::unique_lock lck(m_mtx);
+    // 后备缓冲还没被后台线程取走，说明写盘跟不上，只能等
+    m_cv.wait(lck, [&] { return !m_pending; });
+    m_back = b;
+    m_step = step;
+    m_time = time;
+    m_pending = true;
+    lck.unlock();
+    m_cv.notify_all();
+}
+
+void SnapshotWriter::flush() {
+    std::unique_lock lck(m_mtx);
+    m_cv.wait(lck, [&] { return !m_pending && !m_busy; });
+    if (m_error)
+        std::rethrow_exception(std::exchange(m_error, nullptr));
+}
+
+void SnapshotWriter::worker() {
+    std::unique_lock lck(m_mtx);
+    for (;;) {
+        m_cv.wait(lck, [&] { return m_stop || m_pending; });
+        if (!m_pending)
+            return;
+        std::swap(m_front, m_back);
+        uint64_t step = m_step;
+        double time = m_time;
+        m_pending = false;
+        m_busy = true;
+        lck.unlock();
+        m_cv.notify_all();
+        std::exception_ptr error;
+        try {
+            write_snapshot(path_for(step), m_front, step, time);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        lck.lock();
+        // 只留第一个错误，由下一次 flush() 抛给调用者
+        if (error && !m_error)
+            m_error = error;
+        m_busy = false;
+        m_cv.notify_all();
+    }
+}
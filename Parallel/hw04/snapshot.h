@@ -0,0 +1,67 @@
+#pragma once
+#include "nbody.h"
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// 快照文件格式（小端）：
+//   SnapshotHeader
+//   SnapshotField × nfields          每列的名字、元素类型和在文件中的偏移
+//   各列数据，每列 n 个元素，按 64 字节对齐
+struct SnapshotHeader {
+    char magic[8];       // "NBODYSNP"
+    uint32_t version;    // kSnapshotVersion
+    uint32_t nfields;
+    uint64_t nbodies;
+    uint64_t step;
+    double time;
+};
+
+struct SnapshotField {
+    char name[8];
+    uint32_t type;       // 0 = float32
+    uint32_t reserved;
+    uint64_t offset;
+};
+
+inline constexpr uint32_t kSnapshotVersion = 1;
+
+void write_snapshot(std::string const &path, Bodies const &b, uint64_t step, double time);
+
+// 读回快照；use_mmap 时直接把文件映射进来再拷到 Bodies
+// 版本或格式不对时抛 std::runtime_error
+Bodies load_snapshot(std::string const &path, uint64_t *step = nullptr, double *time = nullptr,
+                     bool use_mmap = true);
+
+// 后台线程异步写快照：submit() 只把当前状态拷进后备缓冲就返回，
+// 写盘在后台线程里和积分同时进行；上一份还没写完时 submit() 才会等待
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::string prefix);
+    ~SnapshotWriter();
+
+    SnapshotWriter(SnapshotWriter const &) = delete;
+    SnapshotWriter &operator=(SnapshotWriter const &) = delete;
+
+    void submit(Bodies const &b, uint64_t step, double time);
+    // 等待所有已提交的快照写完；后台写盘失败过时抛出第一个错误（std::runtime_error）
+    void flush();
+
+    std::string path_for(uint64_t step) const;
+
+private:
+    void worker();
+
+    std::string m_prefix;
+    Bodies m_front, m_back; // m_back 由 submit 填写，m_front 由后台线程写盘
+    uint64_t m_step = 0;
+    double m_time = 0;
+    bool m_pending = false, m_busy = false, m_stop = false;
+    std::exception_ptr m_error; // 后台写盘的第一个错误，flush() 时抛出
+    std::mutex m_mtx;
+    std::condition_variable m_cv;
+    std::thread m_thread;
+};
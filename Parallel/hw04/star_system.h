@@ -0,0 +1,93 @@
+#pragma once
+#include "nbody.h"
+#include "force_law.h"
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+// 编译期常量版的参数，数值与 nbody.cpp 里的全局变量一致
+struct DefaultParams {
+    static constexpr float G = 0.001f;
+    static constexpr float eps = 0.001f;
+    static constexpr float dt = 0.01f;
+};
+
+// 粒子数 N 在编译期确定：std::array 的 SoA，循环边界是常量，
+// 编译器可以完全展开、把整个系统留在寄存器和 L1 里
+// Law 是编译期的力律策略（force_law.h），软化长度取 Params::eps
+template <size_t N, class Params = DefaultParams, class Law = PlummerLaw>
+struct StarSystem {
+    static constexpr float gdt = Params::G * Params::dt;
+    static constexpr float dt = Params::dt;
+
+    alignas(64) std::array<float, N> px, py, pz;
+    alignas(64) std::array<float, N> vx, vy, vz;
+    alignas(64) std::array<float, N> mass;
+
+    // b.size() 必须等于 N
+    static StarSystem from(Bodies const &b) {
+        StarSystem s;
+        for (size_t i = 0; i < N; i++) {
+            s.px[i] = b.px[i]; s.py[i] = b.py[i]; s.pz[i] = b.pz[i];
+            s.vx[i] = b.vx[i]; s.vy[i] = b.vy[i]; s.vz[i] = b.vz[i];
+            s.mass[i] = b.mass[i];
+        }
+        return s;
+    }
+
+    void store(Bodies &b) const {
+        b.resize(N);
+        for (size_t i = 0; i < N; i++) {
+            b.px[i] = px[i]; b.py[i] = py[i]; b.pz[i] = pz[i];
+            b.vx[i] = vx[i]; b.vy[i] = vy[i]; b.vz[i] = vz[i];
+            b.mass[i] = mass[i];
+        }
+    }
+
+    // 与 step() 相同的半隐式欧拉
+    void step() {
+        Law const law(Params::eps);
+        std::array<float, N> gm;
+        for (size_t j = 0; j < N; j++)
+            gm[j] = mass[j] * gdt;
+        for (size_t i = 0; i < N; i++) {
+            float sx = 0, sy = 0, sz = 0;
+#pragma omp simd reduction(+:sx, sy, sz)
+            for (size_t j = 0; j < N; j++) {
+                float dx = px[j] - px[i];
+                float dy = py[j] - py[i];
+                float dz = pz[j] - pz[i];
+                float r2 = dx * dx + dy * dy + dz * dz;
+                float f = gm[j] * law.force(r2);
+                sx += dx * f;
+                sy += dy * f;
+                sz += dz * f;
+            }
+            vx[i] += sx;
+            vy[i] += sy;
+            vz[i] += sz;
+        }
+        for (size_t i = 0; i < N; i++) {
+            px[i] += vx[i] * dt;
+            py[i] += vy[i] * dt;
+            pz[i] += vz[i] * dt;
+        }
+    }
+
+    float calc() const {
+        Law const law(Params::eps);
+        float energy = 0;
+        for (size_t i = 0; i < N; i++) {
+            float v2 = vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i];
+            energy += mass[i] * v2 / 2;
+            for (size_t j = 0; j < N; j++) {
+                float dx = px[j] - px[i];
+                float dy = py[j] - py[i];
+                float dz = pz[j] - pz[i];
+                float r2 = dx * dx + dy * dy + dz * dz;
+                energy -= mass[j] * mass[i] * Params::G * law.potential(r2) / 2;
+            }
+        }
+        return energy;
+    }
+};
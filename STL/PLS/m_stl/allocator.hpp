@@ -0,0 +1,105 @@
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+// Vector 的默认分配器：malloc / free，外加 reallocate 让可平凡搬迁的元素直接 realloc
+template <class T>
+struct MallocAllocator {
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    // realloc 只保证 max_align_t 的对齐，更严格的对齐要求只能走 operator new
+    static constexpr bool over_aligned = alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+    MallocAllocator() = default;
+
+    template <class U>
+    constexpr MallocAllocator(MallocAllocator<U> const &) noexcept {}
+
+    // 常量求值时 malloc 不能用，改走 std::allocator（C++20 起编译期分配只认它）
+    constexpr T *allocate(size_t n) {
+        if (std::is_constant_evaluated())
+            return std::allocator<T>().allocate(n);
+        if (n > std::numeric_limits<size_t>::max() / sizeof(T)) [[unlikely]]
+            throw std::bad_array_new_length();
+        if constexpr (over_aligned) {
+            return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        } else {
+            void *p = std::malloc(n * sizeof(T));
+            if (!p) [[unlikely]]
+                throw std::bad_alloc();
+            return static_cast<T *>(p);
+        }
+    }
+
+    constexpr void deallocate(T *p, size_t n) noexcept {
+        if (std::is_constant_evaluated()) {
+            std::allocator<T>().deallocate(p, n);
+            return;
+        }
+        if constexpr (over_aligned) {
+            ::operator delete(p, std::align_val_t(alignof(T)));
+        } else {
+            std::free(p);
+        }
+    }
+
+    // 按字节把 p 处的 n 个元素扩成 new_n 个，可能原地完成；失败时 p 保持不变
+    T *reallocate(T *p, size_t, size_t new_n) requires (!over_aligned) {
+        if (new_n > std::numeric_limits<size_t>::max() / sizeof(T)) [[unlikely]]
+            throw std::bad_array_new_length();
+        void *q = std::realloc(p, new_n * sizeof(T));
+        if (!q) [[unlikely]]
+            throw std::bad_alloc();
+        return static_cast<T *>(q);
+    }
+
+    friend constexpr bool operator==(MallocAllocator const &, MallocAllocator const &) noexcept {
+        return true;
+    }
+};
+
+// 按 Align 字节对齐，分配的字节数也补齐到 Align 的整数倍：
+// 最后不满一个 SIMD 宽度的那几个元素后面也有内存，可以整块读写（见 simd.hpp）
+template <class T, size_t Align = 64>
+struct AlignedAllocator {
+    static_assert(Align >= alignof(T) && (Align & (Align - 1)) == 0, "Align must be a power of two");
+
+    using value_type = T;
+    using is_always_equal = std::true_type;
+
+    template <class U>
+    struct rebind {
+        using other = AlignedAllocator<U, Align>;
+    };
+
+    AlignedAllocator() = default;
+
+    template <class U>
+    AlignedAllocator(AlignedAllocator<U, Align> const &) noexcept {}
+
+    T *allocate(size_t n) {
+        if (n > (std::numeric_limits<size_t>::max() - Align) / sizeof(T)) [[unlikely]]
+            throw std::bad_array_new_length();
+        size_t bytes = (n * sizeof(T) + Align - 1) & ~(Align - 1);
+        return static_cast<T *>(::operator new(bytes, std::align_val_t(Align)));
+    }
+
+    void deallocate(T *p, size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Align));
+    }
+
+    friend bool operator==(AlignedAllocator const &, AlignedAllocator const &) noexcept {
+        return true;
+    }
+};
+
+// 分配器是否提供 reallocate(p, n, new_n)
+template <class Alloc>
+concept Reallocatable = requires (Alloc &a, typename Alloc::value_type *p, size_t n) {
+    { a.reallocate(p, n, n) } -> std::same_as<typename Alloc::value_type *>;
+};
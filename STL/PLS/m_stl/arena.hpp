@@ -0,0 +1,136 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+// 单调增长的内存池：分配只是挪一下指针，释放什么也不做，reset() 一次性全部回收
+// 适合“每帧建一堆临时容器，帧末全部丢掉”的场景；不是线程安全的
+struct MonotonicArena {
+    explicit MonotonicArena(size_t chunk_size = 1 << 20) : m_chunk_size(chunk_size) {}
+
+    MonotonicArena(MonotonicArena const &) = delete;
+    MonotonicArena &operator=(MonotonicArena const &) = delete;
+
+    ~MonotonicArena() {
+        release();
+    }
+
+    void *allocate(size_t bytes, size_t align) {
+        uintptr_t p = (m_cur + align - 1) & ~(uintptr_t)(align - 1);
+        if (p + bytes > m_end || !m_end) [[unlikely]] {
+            new_chunk(bytes + align);
+            p = (m_cur + align - 1) & ~(uintptr_t)(align - 1);
+        }
+        m_last = p;
+        m_cur = p + bytes;
+        return (void *)p;
+    }
+
+    // 只有最近一次分配的块能原地伸缩，其余情况返回 false
+    bool resize_in_place(void *p, size_t new_bytes) noexcept {
+        if ((uintptr_t)p != m_last || m_last + new_bytes > m_end)
+            return false;
+        m_cur = m_last + new_bytes;
+        return true;
+    }
+
+    // 最近一次分配的块可以退回去，其他的什么也不做
+    void deallocate(void *p, size_t) noexcept {
+        if ((uintptr_t)p == m_last)
+            m_cur = m_last;
+    }
+
+    // 回收所有分配；用了不止一块时合并成一整块，下一轮同样的用量就不用再向系统要内存
+    void reset() {
+        if (m_chunks && m_chunks->next) {
+            size_t total = reserved();
+            release();
+            new_chunk(total - sizeof(Chunk));
+        } else if (m_chunks) {
+            m_cur = (uintptr_t)(m_chunks + 1);
+        }
+        m_last = 0;
+    }
+
+    void release() noexcept {
+        while (m_chunks) {
+            Chunk *next = m_chunks->next;
+            std::free(m_chunks);
+            m_chunks = next;
+        }
+        m_cur = m_end = m_last = 0;
+    }
+
+    // 从系统拿了多少字节
+    size_t reserved() const noexcept {
+        size_t total = 0;
+        for (Chunk *c = m_chunks; c; c = c->next)
+            total += c->size;
+        return total;
+    }
+
+private:
+    struct alignas(std::max_align_t) Chunk {
+        Chunk *next;
+        size_t size;
+    };
+
+    void new_chunk(size_t min_bytes) {
+        size_t size = std::max(m_chunk_size, min_bytes + sizeof(Chunk));
+        auto *c = static_cast<Chunk *>(std::malloc(size));
+        if (!c) [[unlikely]]
+            throw std::bad_alloc();
+        c->next = m_chunks;
+        c->size = size;
+        m_chunks = c;
+        m_cur = (uintptr_t)(c + 1);
+        m_end = (uintptr_t)c + size;
+        m_last = 0;
+    }
+
+    size_t m_chunk_size;
+    Chunk *m_chunks = nullptr;
+    uintptr_t m_cur = 0, m_end = 0, m_last = 0;
+};
+
+template <class T>
+struct ArenaAllocator {
+    using value_type = T;
+    // 容器移动赋值 / swap 时带着 arena 走，拷贝构造时新容器也用同一个 arena
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    MonotonicArena *m_arena;
+
+    explicit ArenaAllocator(MonotonicArena &arena) noexcept : m_arena(&arena) {}
+
+    template <class U>
+    ArenaAllocator(ArenaAllocator<U> const &other) noexcept : m_arena(other.m_arena) {}
+
+    T *allocate(size_t n) {
+        return static_cast<T *>(m_arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *p, size_t n) noexcept {
+        m_arena->deallocate(p, n * sizeof(T));
+    }
+
+    // 最后分配的那块原地伸长，否则在 arena 里另开一块按字节拷过去
+    T *reallocate(T *p, size_t n, size_t new_n) {
+        if (p && m_arena->resize_in_place(p, new_n * sizeof(T)))
+            return p;
+        T *q = allocate(new_n);
+        if (p)
+            std::copy_n(reinterpret_cast<unsigned char *>(p), std::min(n, new_n) * sizeof(T),
+                        reinterpret_cast<unsigned char *>(q));
+        return q;
+    }
+
+    friend bool operator==(ArenaAllocator const &a, ArenaAllocator const &b) noexcept {
+        return a.m_arena == b.m_arena;
+    }
+};
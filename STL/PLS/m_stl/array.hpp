@@ -1,22 +1,33 @@
 #pragma once
-template <class T, size_t N>
+#include <cstddef>
+#include <stdexcept>
+
+// Align 大于 alignof(T) 时，数组按 Align 对齐，并且在末尾补元素凑满 Align 字节的整数倍，
+// SIMD 循环可以整块处理到最后，不用单独处理尾巴；size() 仍然是 N
+// 所有成员都是 constexpr：查找表之类可以在编译期算好，用 constexpr 变量直接放进只读数据段
+template <class T, size_t N, size_t Align = alignof(T)>
 struct Array {
-    T m_elements[N];
+    static_assert(Align >= alignof(T) && (Align & (Align - 1)) == 0, "Align must be a power of two");
+    static_assert(Align == alignof(T) || Align % sizeof(T) == 0, "Align must be a multiple of sizeof(T)");
+    static constexpr size_t lanes = Align == alignof(T) ? 1 : Align / sizeof(T);
+    static constexpr size_t padded_size = (N + lanes - 1) / lanes * lanes;
+
+    alignas(Align) T m_elements[padded_size];
     using value_type = T;
     using iterator = T *;
     using const_iterator = T *;
-    T &operator[](size_t i) noexcept {
+    constexpr T &operator[](size_t i) noexcept {
         return m_elements[i];
     }
-    T const &operator[](size_t i) const noexcept {
+    constexpr T const &operator[](size_t i) const noexcept {
         return m_elements[i];
     }
-    T &at(size_t i) {
+    constexpr T &at(size_t i) {
         if (i >= N) [[unlikely]]
             throw std::runtime_error("out of range!");
         return m_elements[i];
     }
-    T const &at(size_t i) const {
+    constexpr T const &at(size_t i) const {
         if (i >= N) [[unlikely]]
             throw std::runtime_error("out of range!");
         return m_elements[i];
@@ -24,22 +35,22 @@ struct Array {
     static constexpr size_t size() noexcept {
         return N;
     }
-    T const *data() const noexcept {
+    constexpr T const *data() const noexcept {
         return m_elements;
     }
-    T *data() noexcept {
+    constexpr T *data() noexcept {
         return m_elements;
     }
-    T *begin() noexcept {
+    constexpr T *begin() noexcept {
         return m_elements;
     }
-    T *end() noexcept {
+    constexpr T *end() noexcept {
         return m_elements + N;
     }
-    T const *begin() const noexcept {
+    constexpr T const *begin() const noexcept {
         return m_elements;
     }
-    T const *end() const noexcept {
+    constexpr T const *end() const noexcept {
         return m_elements + N;
     } // 有了begin 和 end 可以使用for (auto &ai : a) {...}
 
@@ -0,0 +1,59 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "vector.hpp"
+#include "arena.hpp"
+#include "pool_allocator.hpp"
+
+// 每帧建 m 个 1..16 个元素的小 vector，全部活到帧末再一起销毁；报告每帧用时的中位数
+template <class Vec, class MakeVec, class EndFrame>
+void run(char const *name, size_t m, int frames, MakeVec make_vec, EndFrame end_frame) {
+    std::vector<double> times;
+    long long check = 0;
+    for (int f = 0; f < frames; f++) {
+        auto t0 = std::chrono::steady_clock::now();
+        {
+            std::vector<Vec> frame;
+            frame.reserve(m);
+            for (size_t i = 0; i < m; i++) {
+                Vec &v = frame.emplace_back(make_vec());
+                size_t k = 1 + (i * 7919 + f) % 16;
+                for (size_t j = 0; j < k; j++)
+                    v.push_back((int)(i + j));
+            }
+            for (auto const &v: frame)
+                check += v[v.size() - 1];
+        }
+        end_frame();
+        auto t1 = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    std::sort(times.begin(), times.end());
+    double med = times[times.size() / 2];
+    printf("%-28s %10.3f %10.2f   (%lld)\n", name, med, med * 1e6 / m, check);
+}
+
+// 用法: ./bench_alloc [每帧 vector 个数=1e6] [帧数=10]
+int main(int argc, char **argv) {
+    size_t m = argc > 1 ? (size_t)atof(argv[1]) : 1000000;
+    int frames = argc > 2 ? atoi(argv[2]) : 10;
+    printf("%-28s %10s %10s\n", "allocator", "ms/frame", "ns/vector");
+    auto nothing = [] {};
+    run<std::vector<int>>("std::vector (new)", m, frames, [] { return std::vector<int>(); }, nothing);
+    run<Vector<int>>("Vector (malloc)", m, frames, [] { return Vector<int>(); }, nothing);
+
+    PoolResource pool;
+    run<Vector<int, PoolAllocator<int>>>("Vector (size-class pool)", m, frames, [&] {
+        return Vector<int, PoolAllocator<int>>(PoolAllocator<int>(pool));
+    }, nothing);
+
+    // 帧末整块回收，vector 的析构里的 deallocate 都是空操作
+    MonotonicArena arena(16 << 20);
+    run<Vector<int, ArenaAllocator<int>>>("Vector (arena)", m, frames, [&] {
+        return Vector<int, ArenaAllocator<int>>(ArenaAllocator<int>(arena));
+    }, [&] { arena.reset(); });
+    printf("arena reserved after last frame: %.1f MB\n", arena.reserved() / 1048576.0);
+    return 0;
+}
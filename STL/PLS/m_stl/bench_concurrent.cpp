@@ -0,0 +1,81 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "vector.hpp"
+#include "segmented_vector.hpp"
+#include "concurrent_vector.hpp"
+
+// nthreads 个线程一共追加 n 个元素，返回每次追加的平均用时（墙钟时间 / n）
+template <class Push>
+double run_threads(size_t n, unsigned nthreads, Push push) {
+    std::vector<std::thread> threads;
+    auto t0 = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < nthreads; t++) {
+        threads.emplace_back([&, t] {
+            size_t begin = n * t / nthreads, end = n * (t + 1) / nthreads;
+            for (size_t i = begin; i < end; i++)
+                push((long)i);
+        });
+    }
+    for (auto &th: threads)
+        th.join();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+}
+
+// 用法: ./bench_concurrent [总元素个数=1e7] [最多线程数=64]
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? (size_t)atof(argv[1]) : 10000000;
+    unsigned max_threads = argc > 2 ? (unsigned)atoi(argv[2]) : 64;
+    printf("hardware threads: %u\n", std::thread::hardware_concurrency());
+    printf("%8s %14s %14s %14s %14s %12s\n", "threads", "mutex+Vector", "Segmented", "Concurrent",
+           "Conc+reader", "snapshots");
+    for (unsigned t = 1; t <= max_threads; t *= 2) {
+        double mtx_ns, seg_ns, conc_ns, read_ns;
+        {
+            Vector<long> v;
+            std::mutex mtx;
+            mtx_ns = run_threads(n, t, [&](long x) {
+                std::lock_guard lck(mtx);
+                v.push_back(x);
+            });
+        }
+        {
+            SegmentedVector<long> v;
+            seg_ns = run_threads(n, t, [&](long x) { v.concurrent_emplace_back(x); });
+        }
+        {
+            ConcurrentVector<long> v;
+            conc_ns = run_threads(n, t, [&](long x) { v.push_back(x); });
+        }
+        // 同时有一个读者不停地取快照、把快照里的元素加起来
+        size_t snapshots = 0;
+        {
+            ConcurrentVector<long> v;
+            std::atomic<bool> done{false};
+            long long sum = 0;
+            std::thread reader([&] {
+                while (!done.load(std::memory_order_relaxed)) {
+                    auto snap = v.snapshot();
+                    snap.for_each_segment([&](long const *first, long const *last) {
+                        for (long const *p = first; p != last; p++)
+                            sum += *p;
+                    });
+                    snapshots++;
+                }
+            });
+            read_ns = run_threads(n, t, [&](long x) { v.push_back(x); });
+            done = true;
+            reader.join();
+            if (sum < 0)
+                abort();
+        }
+        printf("%8u %14.2f %14.2f %14.2f %14.2f %12zu\n", t, mtx_ns, seg_ns, conc_ns, read_ns, snapshots);
+    }
+    return 0;
+}
@@ -0,0 +1,142 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "vector.hpp"
+#include "hugepage_allocator.hpp"
+
+// 本线程的 dTLB 读缺失计数；虚拟机里常常没有硬件计数器，打开失败时报 n/a
+struct TlbCounter {
+    int fd = -1;
+
+    TlbCounter() {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HW_CACHE;
+        attr.config = PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                    | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+
+    ~TlbCounter() {
+        if (fd >= 0)
+            close(fd);
+    }
+
+    void start() {
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    long long stop() {
+        long long v = -1;
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &v, sizeof(v)) != sizeof(v))
+                v = -1;
+        }
+        return v;
+    }
+};
+
+// /proc/self/smaps_rollup 里的 AnonHugePages，单位 MB
+double anon_huge_mb() {
+    std::ifstream f("/proc/self/smaps_rollup");
+    std::string key;
+    long long kb;
+    while (f >> key) {
+        if (key == "AnonHugePages:" && f >> kb)
+            return kb / 1024.0;
+    }
+    return 0;
+}
+
+template <class Func>
+double time_ms(Func func) {
+    auto t0 = std::chrono::steady_clock::now();
+    func();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+void print_tlb(long long misses) {
+    if (misses < 0)
+        printf(" %12s", "n/a");
+    else
+        printf(" %12lld", misses);
+}
+
+// 顺序求和测带宽，随机下标求和测 TLB：每次访问几乎都落在不同的 4KB 页上
+template <class Alloc>
+void run(char const *name, size_t n, size_t nrand, WorkStealingPool &pool, Alloc alloc) {
+    double huge0 = anon_huge_mb();
+    double touch_ms, seq_ms, rand_ms;
+    long long seq_tlb, rand_tlb;
+    uint64_t check = 0;
+    {
+        Vector<uint64_t, Alloc> v(alloc);
+        v.resize_default_init(n);
+        touch_ms = time_ms([&] { parallel_first_touch(pool, v.data(), n * sizeof(uint64_t)); });
+        for (size_t i = 0; i < n; i++)
+            v[i] = i;
+        double huge = anon_huge_mb() - huge0;
+
+        TlbCounter tlb;
+        tlb.start();
+        seq_ms = time_ms([&] {
+            for (size_t i = 0; i < n; i++)
+                check += v[i];
+        });
+        seq_tlb = tlb.stop();
+
+        // n 是 2 的幂，乘一个大奇数后取模是 [0, n) 的一个排列
+        size_t mask = n - 1;
+        tlb.start();
+        rand_ms = time_ms([&] {
+            for (size_t i = 0; i < nrand; i++)
+                check += v[(i * 0x9E3779B97F4A7C15ull) & mask];
+        });
+        rand_tlb = tlb.stop();
+
+        printf("%-22s %8.1f %9.1f %9.2f", name, huge, touch_ms, n * sizeof(uint64_t) / seq_ms / 1e6);
+        print_tlb(seq_tlb);
+        printf(" %9.2f", rand_ms * 1e6 / nrand);
+        print_tlb(rand_tlb);
+        printf("   (%llu)\n", (unsigned long long)check);
+    }
+}
+
+// 用法: ./bench_hugepage [缓冲区 MB=1024] [随机访问次数=2e7]
+int main(int argc, char **argv) {
+    size_t mb = argc > 1 ? (size_t)atof(argv[1]) : 1024;
+    size_t nrand = argc > 2 ? (size_t)atof(argv[2]) : 20000000;
+    size_t n = 1;
+    while (n * 2 * sizeof(uint64_t) <= mb << 20)
+        n *= 2;
+    WorkStealingPool pool(std::thread::hardware_concurrency());
+    printf("buffer %zu MB, %u threads, %u NUMA nodes\n", n * sizeof(uint64_t) >> 20, pool.size(),
+           hugepage_detail::numa_node_count());
+    printf("%-22s %8s %9s %9s %12s %9s %12s\n", "allocator", "huge MB", "touch ms", "seq GB/s",
+           "seq dTLB", "rand ns", "rand dTLB");
+    run("malloc", n, nrand, pool, MallocAllocator<uint64_t>());
+    run("mmap 4KB", n, nrand, pool, HugePageAllocator<uint64_t>(HugePageMode::None));
+    run("mmap THP", n, nrand, pool, HugePageAllocator<uint64_t>(HugePageMode::Transparent));
+    run("hugetlb (or THP)", n, nrand, pool, HugePageAllocator<uint64_t>(HugePageMode::HugeTLB));
+    run("THP interleave", n, nrand, pool,
+        HugePageAllocator<uint64_t>(HugePageMode::Transparent, NumaPolicy::Interleave));
+    return 0;
+}
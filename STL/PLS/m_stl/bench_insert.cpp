@@ -0,0 +1,66 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "vector.hpp"
+
+// 带自定义移动构造的 int：不是可平凡搬迁的，Vector 只能逐个移动
+struct Boxed {
+    int x;
+    Boxed(int x = 0) noexcept : x(x) {}
+    Boxed(Boxed const &o) noexcept : x(o.x) {}
+    Boxed &operator=(Boxed const &o) noexcept {
+        x = o.x;
+        return *this;
+    }
+};
+
+template <class T>
+int value(T const &t) {
+    if constexpr (std::is_same_v<T, Boxed>)
+        return t.x;
+    else
+        return t;
+}
+
+// 在 n 个元素的中间反复插入 / 删除 k 个元素，每次都要挪动后一半；报告每次操作的中位数用时
+template <class Vec>
+void run(char const *name, size_t n, size_t k, int ops) {
+    using T = typename Vec::value_type;
+    Vec v(n);
+    std::vector<T> block(k, T(1));
+    std::vector<double> ins, era;
+    long long check = 0;
+    for (int r = 0; r < ops; r++) {
+        auto t0 = std::chrono::steady_clock::now();
+        v.insert(v.begin() + n / 2, block.data(), block.data() + k);
+        auto t1 = std::chrono::steady_clock::now();
+        v.erase(v.begin() + n / 3, v.begin() + n / 3 + k);
+        auto t2 = std::chrono::steady_clock::now();
+        check += value(v[n / 2]);
+        ins.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+        era.push_back(std::chrono::duration<double, std::milli>(t2 - t1).count());
+    }
+    std::sort(ins.begin(), ins.end());
+    std::sort(era.begin(), era.end());
+    double mi = ins[ins.size() / 2], me = era[era.size() / 2];
+    // 每次挪动约 n/2 个元素，折算成搬运带宽
+    double bytes = n / 2.0 * sizeof(T);
+    printf("%-22s %6zu %9.3f %9.3f %8.2f %8.2f   (%lld)\n", name, k, mi, me,
+           bytes / mi / 1e6, bytes / me / 1e6, check);
+}
+
+// 用法: ./bench_insert [元素个数=1e7] [每组次数=20]
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? (size_t)atof(argv[1]) : 10000000;
+    int ops = argc > 2 ? atoi(argv[2]) : 20;
+    printf("%-22s %6s %9s %9s %8s %8s\n", "container", "k", "ins ms", "era ms", "ins GB/s", "era GB/s");
+    for (size_t k: {1, 100}) {
+        run<std::vector<int>>("std::vector<int>", n, k, ops);
+        run<Vector<int>>("Vector<int>", n, k, ops);
+        run<std::vector<Boxed>>("std::vector<Boxed>", n, k, ops);
+        run<Vector<Boxed>>("Vector<Boxed>", n, k, ops);
+    }
+    return 0;
+}
@@ -0,0 +1,71 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <thread>
+#include "vector.hpp"
+#include "parallel_algorithm.hpp"
+
+template <class Func>
+double time_ms(Func func) {
+    auto t0 = std::chrono::steady_clock::now();
+    func();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+// 用法: ./bench_parallel [元素个数=1e8] [最多线程数=全部核]
+// 每个算法先跑一遍 std 的串行版本作为基准，再按 1, 2, 4 ... 个线程跑并行版本
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? (size_t)atof(argv[1]) : 100000000;
+    unsigned max_threads = argc > 2 ? (unsigned)atoi(argv[2]) : std::thread::hardware_concurrency();
+    Vector<int> src = Vector<int>::generate(n, [](size_t i) { return (int)((i * 2654435761u) >> 8); });
+    Vector<int> v(n, default_init);
+    Vector<int> out(n, default_init);
+    auto reset = [&] { std::copy(src.begin(), src.end(), v.begin()); };
+    auto is_even = [](int x) { return x % 2 == 0; };
+    long long check = 0;
+
+    // 先把所有页都碰一遍，缺页不要算进第一个被测的算法里
+    reset();
+    std::fill(out.begin(), out.end(), 0);
+
+    printf("%-12s %8s %10s %8s\n", "algorithm", "threads", "ms", "speedup");
+    double base[6];
+    base[0] = time_ms([&] { std::for_each(v.begin(), v.end(), [](int &x) { x = x * 3 + 1; }); });
+    base[1] = time_ms([&] { std::transform(src.begin(), src.end(), out.begin(), [](int x) { return x ^ (x >> 3); }); });
+    base[2] = time_ms([&] { check += std::reduce(src.begin(), src.end(), 0LL); });
+    base[3] = time_ms([&] { std::inclusive_scan(src.begin(), src.end(), out.begin()); });
+    reset();
+    base[4] = time_ms([&] { std::sort(v.begin(), v.end()); });
+    reset();
+    base[5] = time_ms([&] { std::stable_partition(v.begin(), v.end(), is_even); });
+    char const *names[6] = {"for_each", "transform", "reduce", "scan", "sort", "partition"};
+    for (int k = 0; k < 6; k++)
+        printf("%-12s %8s %10.2f %8.2f\n", names[k], "std", base[k], 1.0);
+
+    for (unsigned t = 1;; t = std::min(t * 2, max_threads)) {
+        WorkStealingPool pool(t);
+        double ms[6];
+        reset();
+        ms[0] = time_ms([&] { parallel_for_each(pool, v.begin(), v.end(), [](int &x) { x = x * 3 + 1; }); });
+        ms[1] = time_ms([&] {
+            parallel_transform(pool, src.begin(), src.end(), out.begin(), [](int x) { return x ^ (x >> 3); });
+        });
+        ms[2] = time_ms([&] { check += parallel_reduce(pool, src.begin(), src.end(), 0LL); });
+        ms[3] = time_ms([&] { parallel_inclusive_scan(pool, src.begin(), src.end(), out.begin()); });
+        reset();
+        ms[4] = time_ms([&] { parallel_sort(pool, v.begin(), v.end()); });
+        if (!std::is_sorted(v.begin(), v.end()))
+            abort();
+        reset();
+        ms[5] = time_ms([&] { parallel_partition(pool, v.begin(), v.end(), is_even); });
+        for (int k = 0; k < 6; k++)
+            printf("%-12s %8u %10.2f %8.2f\n", names[k], t, ms[k], base[k] / ms[k]);
+        if (t == max_threads)
+            break;
+    }
+    printf("(%lld)\n", check);
+    return 0;
+}
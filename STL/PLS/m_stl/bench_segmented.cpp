@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "vector.hpp"
+#include "segmented_vector.hpp"
+#include "thread_pool.hpp"
+
+template <class Func>
+double best_ms(int reps, Func func) {
+    double best = 1e300;
+    for (int r = 0; r < reps; r++) {
+        auto t0 = std::chrono::steady_clock::now();
+        func();
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    return best;
+}
+
+// 追加 n 个元素，然后按顺序和随机下标各读一遍
+template <class Vec>
+void run(char const *name, size_t n, int reps) {
+    long long check = 0;
+    double append = best_ms(reps, [&] {
+        Vec v;
+        for (size_t i = 0; i < n; i++)
+            v.push_back((int)i);
+        check += v[n / 2];
+    });
+    Vec v;
+    for (size_t i = 0; i < n; i++)
+        v.push_back((int)i);
+    double seq = best_ms(reps, [&] {
+        for (size_t i = 0; i < n; i++)
+            check += v[i];
+    });
+    double rnd = best_ms(reps, [&] {
+        size_t j = 0;
+        for (size_t i = 0; i < n; i++) {
+            j = (j * 6364136223846793005ull + 1442695040888963407ull);
+            check += v[(j >> 20) % n];
+        }
+    });
+    printf("%-24s %10.2f %10.2f %10.2f   (%lld)\n", name, append * 1e6 / n, seq * 1e6 / n, rnd * 1e6 / n, check);
+}
+
+// 用法: ./bench_segmented [元素个数=1e8] [重复次数=3]
+int main(int argc, char **argv) {
+    size_t n = argc > 1 ? (size_t)atof(argv[1]) : 100000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 3;
+    printf("%-24s %10s %10s %10s\n", "container", "append ns", "seq ns", "random ns");
+    run<std::vector<int>>("std::vector", n, reps);
+    run<Vector<int>>("Vector", n, reps);
+    run<SegmentedVector<int>>("SegmentedVector", n, reps);
+    run<SegmentedVector<int, 4096>>("SegmentedVector<4096>", n, reps);
+
+    // 分段顺序访问：每段里是连续内存，不用每个元素算一次段号
+    SegmentedVector<int> s;
+    for (size_t i = 0; i < n; i++)
+        s.push_back((int)i);
+    long long sum = 0;
+    double seg = best_ms(reps, [&] {
+        s.for_each_segment([&](int *first, int *last) {
+            for (int *p = first; p != last; p++)
+                sum += *p;
+        });
+    });
+    printf("%-24s %10s %10.2f %10s   (%lld)\n", "  for_each_segment", "", seg * 1e6 / n, "", sum);
+
+    // 池里所有线程一起追加
+    WorkStealingPool pool(std::thread::hardware_concurrency());
+    double conc = best_ms(reps, [&] {
+        SegmentedVector<int> c;
+        pool.parallel_for(n, 1 << 16, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; i++)
+                c.concurrent_emplace_back((int)i);
+        });
+    });
+    printf("%-24s %10.2f   (%u threads)\n", "  concurrent append", conc * 1e6 / n, pool.size());
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "vector.hpp"
+#include "simd.hpp"
+
+// lanes 个独立的累加器，和对齐版本的写法一致，只是指针没有对齐保证、最后有标量尾巴
+template <size_t Lanes>
+float dot_unaligned(float const *x, float const *y, size_t n) {
+    float acc[Lanes] = {};
+    size_t i = 0;
+    for (; i + Lanes <= n; i += Lanes)
+        for (size_t k = 0; k < Lanes; k++)
+            acc[k] += x[i + k] * y[i + k];
+    float s = 0;
+    for (; i < n; i++)
+        s += x[i] * y[i];
+    for (size_t k = 0; k < Lanes; k++)
+        s += acc[k];
+    return s;
+}
+
+template <size_t Lanes>
+void saxpy_unaligned(float a, float const *x, float *y, size_t n) {
+    size_t i = 0;
+    for (; i + Lanes <= n; i += Lanes)
+        for (size_t k = 0; k < Lanes; k++)
+            y[i + k] += a * x[i + k];
+    for (; i < n; i++)
+        y[i] += a * x[i];
+}
+
+// 补出来的元素都是 0，不影响点积；整块处理到底，没有尾巴
+template <size_t Align>
+float dot_aligned(simd_view<float, Align> x, simd_view<float, Align> y) {
+    constexpr size_t L = simd_view<float, Align>::lanes;
+    float acc[L] = {};
+    float const *px = x.data(), *py = y.data();
+    for (size_t i = 0; i < x.size(); i += L)
+        for (size_t k = 0; k < L; k++)
+            acc[k] += px[i + k] * py[i + k];
+    float s = 0;
+    for (size_t k = 0; k < L; k++)
+        s += acc[k];
+    return s;
+}
+
+// y 的补齐部分也被写了，反正是补出来的
+template <size_t Align>
+void saxpy_aligned(float a, simd_view<float, Align> x, simd_view<float, Align> y) {
+    float const *px = x.data();
+    float *py = y.data();
+    for (size_t i = 0; i < x.size(); i++)
+        py[i] += a * px[i];
+}
+
+template <class Func>
+double best_ns(size_t reps, Func func) {
+    double best = 1e300;
+    for (int r = 0; r < 5; r++) {
+        auto t0 = std::chrono::steady_clock::now();
+        for (size_t k = 0; k < reps; k++)
+            func();
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count() / reps);
+    }
+    return best;
+}
+
+// 用法: ./bench_simd [最大元素个数=1.6e7]
+// 每个 n 故意取成不是 16 的倍数，未对齐版本每次都要走标量尾巴
+int main(int argc, char **argv) {
+    size_t max_n = argc > 1 ? (size_t)atof(argv[1]) : 16000000;
+    constexpr size_t Align = 64;
+    constexpr size_t L = Align / sizeof(float);
+    printf("%-10s %10s %12s %12s %12s %12s\n", "n", "", "dot GF/s", "saxpy GF/s", "dot ns", "saxpy ns");
+    for (size_t n = 1003; n <= max_n; n *= 4) {
+        size_t reps = std::max<size_t>(1, 100000000 / n);
+        float sink = 0;
+
+        // 未对齐：普通 Vector 上错开一个元素，首地址只有 4 字节对齐
+        Vector<float> ux(n + 1, 1.0f), uy(n + 1, 2.0f);
+        float *px = ux.data() + 1, *py = uy.data() + 1;
+        double ud = best_ns(reps, [&] { sink += dot_unaligned<L>(px, py, n); });
+        double us = best_ns(reps, [&] { saxpy_unaligned<L>(1e-6f, px, py, n); });
+
+        AlignedVector<float, Align> ax(n, 1.0f), ay(n, 2.0f);
+        auto vx = make_simd_view(ax, 0.0f);
+        auto vy = make_simd_view(ay, 0.0f);
+        double ad = best_ns(reps, [&] { sink += dot_aligned(vx, vy); });
+        double as = best_ns(reps, [&] { saxpy_aligned(1e-6f, vx, vy); });
+
+        printf("%-10zu %10s %12.2f %12.2f %12.1f %12.1f\n", n, "unaligned", 2 * n / ud, 2 * n / us, ud, us);
+        printf("%-10zu %10s %12.2f %12.2f %12.1f %12.1f   (%g)\n", n, "aligned", 2 * n / ad, 2 * n / as, ad, as, sink);
+    }
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "vector.hpp"
+#include "small_vector.hpp"
+
+// 建 m 个小容器，元素个数按 sizes(i) 取，全部活到最后一起销毁；报告中位数
+template <class Vec, class Sizes>
+void run(char const *name, size_t m, int reps, Sizes sizes) {
+    std::vector<double> times;
+    long long check = 0;
+    for (int r = 0; r < reps; r++) {
+        auto t0 = std::chrono::steady_clock::now();
+        {
+            std::vector<Vec> all(m);
+            for (size_t i = 0; i < m; i++) {
+                Vec &v = all[i];
+                size_t k = sizes(i, r);
+                for (size_t j = 0; j < k; j++)
+                    v.push_back((int)(i + j));
+            }
+            for (auto const &v: all)
+                for (int x: v)
+                    check += x;
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        times.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+    std::sort(times.begin(), times.end());
+    double med = times[times.size() / 2];
+    printf("%-26s %10.3f %10.2f   (%lld)\n", name, med, med * 1e6 / m, check);
+}
+
+template <class Sizes>
+void run_all(char const *title, size_t m, int reps, Sizes sizes) {
+    printf("-- %s\n", title);
+    run<std::vector<int>>("std::vector", m, reps, sizes);
+    run<Vector<int>>("Vector", m, reps, sizes);
+    run<SmallVector<int, 8>>("SmallVector<int, 8>", m, reps, sizes);
+    run<SmallVector<int, 16>>("SmallVector<int, 16>", m, reps, sizes);
+}
+
+// 用法: ./bench_small_vector [容器个数=1e6] [重复次数=10]
+int main(int argc, char **argv) {
+    size_t m = argc > 1 ? (size_t)atof(argv[1]) : 1000000;
+    int reps = argc > 2 ? atoi(argv[2]) : 10;
+    printf("%-26s %10s %10s\n", "container", "ms", "ns/vector");
+    run_all("1..16 elements", m, reps, [](size_t i, int r) { return 1 + (i * 7919 + r) % 16; });
+    run_all("1..4 elements", m, reps, [](size_t i, int r) { return 1 + (i * 7919 + r) % 4; });
+    // 偶尔有大的：1/16 的容器装 100 个，其余 1..8 个
+    run_all("mostly small, 1/16 large", m, reps, [](size_t i, int r) {
+        size_t h = i * 7919 + r;
+        return h % 16 == 0 ? 100 : 1 + h % 8;
+    });
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "vector.hpp"
+
+// 生成一个马上要被整个覆盖的大缓冲区：先清零再写 vs 只写一次
+// 报告用时和按“有用字节数 / 用时”算的有效带宽
+
+static float pixel(size_t i) {
+    return (float)(i & 1023) * 0.5f;
+}
+
+template <class Func>
+void run(char const *name, size_t bytes, Func func) {
+    auto t0 = std::chrono::steady_clock::now();
+    float check = func();
+    auto t1 = std::chrono::steady_clock::now();
+    double s = std::chrono::duration<double>(t1 - t0).count();
+    printf("%-36s %10.1f %8.2f   (%g)\n", name, s * 1e3, bytes / s * 1e-9, check);
+}
+
+// 用法: ./bench_uninit [GB=1]
+int main(int argc, char **argv) {
+    double gb = argc > 1 ? atof(argv[1]) : 1;
+    size_t n = (size_t)(gb * (1 << 30)) / sizeof(float);
+    size_t bytes = n * sizeof(float);
+    printf("%zu floats (%.2f GB)\n", n, bytes / 1e9);
+    printf("%-36s %10s %8s\n", "fresh buffer", "ms", "GB/s");
+    run("std::vector(n) + fill", bytes, [&] {
+        std::vector<float> v(n);
+        for (size_t i = 0; i < n; i++)
+            v[i] = pixel(i);
+        return v[n / 2 + 1];
+    });
+    run("Vector(n) + fill", bytes, [&] {
+        Vector<float> v(n);
+        for (size_t i = 0; i < n; i++)
+            v[i] = pixel(i);
+        return v[n / 2 + 1];
+    });
+    run("Vector(n, default_init) + fill", bytes, [&] {
+        Vector<float> v(n, default_init);
+        for (size_t i = 0; i < n; i++)
+            v[i] = pixel(i);
+        return v[n / 2 + 1];
+    });
+    run("Vector::generate", bytes, [&] {
+        auto v = Vector<float>::generate(n, pixel);
+        return v[n / 2 + 1];
+    });
+
+    // 页已经映射好的缓冲区反复重用：这里省下的就是纯粹的一遍写带宽
+    printf("%-36s %10s %8s\n", "reused buffer", "ms", "GB/s");
+    Vector<float> buf;
+    buf.reserve(n);
+    buf.resize(n);
+    for (int rep = 0; rep < 2; rep++) {
+        run("clear + resize(n) + fill", bytes, [&] {
+            buf.clear();
+            buf.resize(n);
+            for (size_t i = 0; i < n; i++)
+                buf[i] = pixel(i);
+            return buf[n / 2 + 1];
+        });
+        run("clear + resize_default_init + fill", bytes, [&] {
+            buf.clear();
+            buf.resize_default_init(n);
+            for (size_t i = 0; i < n; i++)
+                buf[i] = pixel(i);
+            return buf[n / 2 + 1];
+        });
+        run("clear + reserve_uninitialized", bytes, [&] {
+            buf.clear();
+            float *p = buf.reserve_uninitialized(n);
+            for (size_t i = 0; i < n; i++)
+                p[i] = pixel(i);
+            buf.commit_uninitialized(n);
+            return buf[n / 2 + 1];
+        });
+        run("clear + append_generate", bytes, [&] {
+            buf.clear();
+            buf.append_generate(n, pixel);
+            return buf[n / 2 + 1];
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "vector.hpp"
+
+// 连续 push_back n 个元素的用时（取 reps 次里最快的一次），以及扩容时数据搬了几次家
+template <class Vec, class Make>
+void run(char const *name, size_t n, int reps, Make make) {
+    double best = 1e300;
+    size_t grows = 0, moves = 0;
+    for (int r = 0; r < reps; r++) {
+        grows = moves = 0;
+        auto t0 = std::chrono::steady_clock::now();
+        {
+            Vec v;
+            auto const *last = v.data();
+            size_t cap = v.capacity();
+            for (size_t i = 0; i < n; i++) {
+                v.push_back(make(i));
+                if (v.capacity() != cap) {
+                    grows++;
+                    moves += v.data() != last && cap != 0;
+                    cap = v.capacity();
+                    last = v.data();
+                }
+            }
+            if (v[n / 2] != make(n / 2))
+                abort();
+        }
+        auto t1 = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration<double>(t1 - t0).count());
+    }
+    printf("%-24s %12zu %10.3f %8.2f %6zu %6zu\n", name, n, best * 1e3, best / n * 1e9, grows, moves);
+}
+
+// 用法: ./bench_vector [最大 N=1e8]
+// N=1e9 的 int 需要 4GB；std::vector 翻倍时新旧两块同时存在，峰值要 6GB 以上
+int main(int argc, char **argv) {
+    size_t max_n = argc > 1 ? (size_t)atof(argv[1]) : 100000000;
+    printf("%-24s %12s %10s %8s %6s %6s\n", "container", "N", "ms", "ns/elem", "grows", "moves");
+    auto make_int = [](size_t i) { return (int)i; };
+    for (size_t n = 1000; n <= max_n; n *= 10) {
+        int reps = n <= 1000000 ? 5 : 1;
+        run<std::vector<int>>("std::vector<int>", n, reps, make_int);
+        run<Vector<int, MallocAllocator<int>, GrowDouble>>("Vector<int> 2x", n, reps, make_int);
+        run<Vector<int, MallocAllocator<int>, GrowGolden>>("Vector<int> 1.5x", n, reps, make_int);
+        run<Vector<int, MallocAllocator<int>, GrowPageAware<>>>("Vector<int> page", n, reps, make_int);
+    }
+    // 非平凡类型走移动构造，不能 realloc
+    auto make_str = [](size_t i) { return std::string(24, 'a' + i % 26); };
+    for (size_t n = 1000; n <= std::min(max_n, (size_t)10000000); n *= 10) {
+        int reps = n <= 1000000 ? 5 : 1;
+        run<std::vector<std::string>>("std::vector<string>", n, reps, make_str);
+        run<Vector<std::string>>("Vector<string> 2x", n, reps, make_str);
+    }
+    return 0;
+}
@@ -0,0 +1,219 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "segmented_vector.hpp"
+
+// 多个线程同时 push_back、同时还有线程在读的 Vector
+// 段的布局和 SegmentedVector 一样（大小翻倍、从不搬家），所以扩容时读者不用停下来
+// push_back：先分配好段，再 CAS 预定一个下标，在那里构造元素，再把这个位置的 ready 标志置位（release）
+// 读者只看 snapshot()：从已发布的前缀往后扫 ready 标志，得到一个所有元素都构造完毕的前缀 [0, n)
+// 之后的写入不会改动这个前缀里的任何东西，所以快照在容器活着的时候一直有效
+template <class T, size_t B = 64>
+struct ConcurrentVector {
+    static_assert(alignof(T) <= alignof(std::max_align_t), "segments come from malloc");
+
+    using value_type = T;
+    using Layout = SegmentedVector<T, B>;
+    static constexpr size_t kMaxSegments = Layout::kMaxSegments;
+
+    ConcurrentVector() noexcept = default;
+
+    ConcurrentVector(ConcurrentVector const &) = delete;
+    ConcurrentVector &operator=(ConcurrentVector const &) = delete;
+
+    // 析构时不能再有写者或读者
+    ~ConcurrentVector() {
+        size_t n = m_reserved.load(std::memory_order_acquire);
+        for (size_t k = 0; k < kMaxSegments; k++) {
+            Segment *seg = m_segs[k].load(std::memory_order_acquire);
+            if (!seg)
+                continue;
+            size_t begin = Layout::segment_begin(k);
+            size_t count = n > begin ? std::min(Layout::segment_size(k), n - begin) : 0;
+            for (size_t j = 0; j < count; j++) {
+                if (seg->flags(k)[j].load(std::memory_order_relaxed))
+                    std::destroy_at(seg->data() + j);
+            }
+            std::free(seg);
+        }
+    }
+
+    // 任意多个线程可以同时调用；返回元素的下标
+    // 下标一旦预定就不能作废，预定之后抛异常的话这个位置永远不会就绪，后面的元素也全都发布不出去
+    // 所以先把下标所在的段分配好再用 CAS 预定，分配失败（bad_alloc）时什么都没预定，容器不变；
+    // CAS 失败说明别的线程抢先预定了，换成新的下标重来，总有一个线程成功（lock-free）
+    // 构造也必须 noexcept；可能抛异常的（比如拷贝 std::string）先在外面构造好，再 push_back(std::move(x))
+    template <class ...Args>
+    size_t emplace_back(Args &&...args) {
+        static_assert(std::is_nothrow_constructible_v<T, Args &&...>,
+                      "construct the element outside and push_back(std::move(x))");
+        size_t i = m_reserved.load(std::memory_order_relaxed);
+        size_t k;
+        Segment *seg;
+        do {
+            k = Layout::segment_of(i);
+            seg = segment(k);
+        } while (!m_reserved.compare_exchange_weak(i, i + 1, std::memory_order_relaxed));
+        size_t j = i - Layout::segment_begin(k);
+        ::new ((void *)(seg->data() + j)) T(std::forward<Args>(args)...);
+        seg->flags(k)[j].store(1, std::memory_order_release);
+        return i;
+    }
+
+    size_t push_back(T const &val) {
+        return emplace_back(val);
+    }
+
+    size_t push_back(T &&val) {
+        return emplace_back(std::move(val));
+    }
+
+    // 已经预定出去的位置个数，里面可能有还没构造完的
+    size_t reserved() const noexcept {
+        return m_reserved.load(std::memory_order_relaxed);
+    }
+
+    // 下标 i 的元素；只能访问某个快照范围之内的下标
+    // 只给 const 引用：发布出去的元素别的线程可能正在读，改它就破坏了快照不变的保证
+    T const &operator[](size_t i) const noexcept {
+        size_t k = Layout::segment_of(i);
+        return m_segs[k].load(std::memory_order_acquire)->data()[i - Layout::segment_begin(k)];
+    }
+
+    // 所有元素都已经构造完毕的最长前缀的长度
+    size_t published() const noexcept {
+        size_t n = m_published.load(std::memory_order_acquire);
+        size_t limit = m_reserved.load(std::memory_order_relaxed);
+        while (n < limit) {
+            size_t k = Layout::segment_of(n);
+            Segment *seg = m_segs[k].load(std::memory_order_acquire);
+            if (!seg)
+                break;
+            auto *flags = seg->flags(k);
+            size_t j = n - Layout::segment_begin(k);
+            size_t end = std::min(Layout::segment_size(k), limit - Layout::segment_begin(k));
+            while (j < end && flags[j].load(std::memory_order_acquire))
+                j++;
+            n = Layout::segment_begin(k) + j;
+            if (j < end)
+                break;
+        }
+        // 把扫过的部分记下来，别的读者下次从这里接着扫
+        size_t cur = m_published.load(std::memory_order_relaxed);
+        while (cur < n && !m_published.compare_exchange_weak(cur, n, std::memory_order_release,
+                                                             std::memory_order_relaxed))
+            ;
+        return n;
+    }
+
+    struct Snapshot {
+        ConcurrentVector const *m_owner;
+        size_t m_size;
+
+        size_t size() const noexcept {
+            return m_size;
+        }
+
+        bool empty() const noexcept {
+            return m_size == 0;
+        }
+
+        T const &operator[](size_t i) const noexcept {
+            return (*m_owner)[i];
+        }
+
+        // 按段依次调用 func(T const *first, T const *last)
+        template <class Func>
+        void for_each_segment(Func &&func) const {
+            for (size_t k = 0; Layout::segment_begin(k) < m_size; k++) {
+                T const *seg = m_owner->m_segs[k].load(std::memory_order_acquire)->data();
+                func(seg, seg + std::min(Layout::segment_size(k), m_size - Layout::segment_begin(k)));
+            }
+        }
+
+        struct iterator {
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using reference = T const &;
+            using pointer = T const *;
+
+            Snapshot const *m_snap = nullptr;
+            size_t m_index = 0;
+
+            T const &operator*() const noexcept {
+                return (*m_snap)[m_index];
+            }
+
+            iterator &operator++() noexcept {
+                ++m_index;
+                return *this;
+            }
+
+            iterator operator++(int) noexcept {
+                auto old = *this;
+                ++m_index;
+                return old;
+            }
+
+            bool operator==(iterator const &other) const noexcept {
+                return m_index == other.m_index;
+            }
+        };
+
+        iterator begin() const noexcept {
+            return {this, 0};
+        }
+
+        iterator end() const noexcept {
+            return {this, m_size};
+        }
+    };
+
+    // 一致的快照：里面的元素都构造完毕，之后也不会被改动
+    Snapshot snapshot() const noexcept {
+        return {this, published()};
+    }
+
+private:
+    // 一段内存：前面是 B << k 个 T，后面跟同样个数的 ready 标志
+    struct Segment {
+        T *data() noexcept {
+            return reinterpret_cast<T *>(this);
+        }
+
+        std::atomic<uint8_t> *flags(size_t k) noexcept {
+            return reinterpret_cast<std::atomic<uint8_t> *>(reinterpret_cast<unsigned char *>(this)
+                                                            + Layout::segment_size(k) * sizeof(T));
+        }
+    };
+
+    Segment *segment(size_t k) {
+        Segment *seg = m_segs[k].load(std::memory_order_acquire);
+        if (seg) [[likely]]
+            return seg;
+        // 多个线程同时发现缺同一段时各自分配，CAS 决出一个，输的把自己的释放掉
+        size_t n = Layout::segment_size(k);
+        auto *fresh = static_cast<Segment *>(std::malloc(n * sizeof(T) + n));
+        if (!fresh) [[unlikely]]
+            throw std::bad_alloc();
+        auto *flags = fresh->flags(k);
+        for (size_t j = 0; j < n; j++)
+            ::new ((void *)(flags + j)) std::atomic<uint8_t>(0);
+        if (m_segs[k].compare_exchange_strong(seg, fresh, std::memory_order_acq_rel))
+            return fresh;
+        std::free(fresh);
+        return seg;
+    }
+
+    std::atomic<Segment *> m_segs[kMaxSegments] = {};
+    alignas(64) std::atomic<size_t> m_reserved{0};
+    alignas(64) mutable std::atomic<size_t> m_published{0};
+};
@@ -0,0 +1,42 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+// 容量增长策略：next(cap, need, elem_size) 返回不小于 need 的新容量（元素个数）
+
+// 每次翻倍，均摊 O(1)，但新块永远比之前释放的所有块加起来还大，分配器没法复用它们
+struct GrowDouble {
+    static constexpr size_t next(size_t cap, size_t need, size_t) noexcept {
+        return std::max(need, cap * 2);
+    }
+};
+
+// 1.5 倍：几次之后之前释放的块加起来够放下新块，内存峰值也低一些
+struct GrowGolden {
+    static constexpr size_t next(size_t cap, size_t need, size_t) noexcept {
+        return std::max(need, cap + cap / 2 + 1);
+    }
+};
+
+// 小块翻倍；超过 Threshold 字节后改成 1.5 倍并把字节数凑成整页，
+// 这种块 glibc 是直接 mmap 的，realloc 时可以用 mremap 原地扩展，不用拷贝
+template <size_t PageSize = 4096, size_t Threshold = (size_t)1 << 20>
+struct GrowPageAware {
+    static constexpr size_t next(size_t cap, size_t need, size_t elem_size) noexcept {
+        size_t n = std::max(need, cap * 2);
+        if (n * elem_size < Threshold)
+            return n;
+        n = std::max(need, cap + cap / 2);
+        size_t bytes = (n * elem_size + PageSize - 1) / PageSize * PageSize;
+        return bytes / elem_size;
+    }
+};
+
+// 可以按字节搬到新地址、旧地址上不用析构的类型：可以直接 realloc
+// 默认只认平凡可拷贝的类型；自己的类型（比如只持有一个指针的句柄）可以特化成 true
+template <class T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <class T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
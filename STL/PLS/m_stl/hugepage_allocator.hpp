@@ -0,0 +1,224 @@
+#pragma once
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <dirent.h>
+#include "thread_pool.hpp"
+
+// 大块内存直接 mmap，按 2MB 对齐并 madvise(MADV_HUGEPAGE)，让内核用透明大页（THP）来映射，
+// 几个 GB 的缓冲区 TLB 项少 512 倍；也可以选 hugetlbfs 的预留大页（MAP_HUGETLB，需要先配置 nr_hugepages）
+// 另外可以用 mbind 指定 NUMA 策略：交错分布到所有节点，或者绑到某个节点上
+// 小于 kMinBytes 的分配不值得占一整个大页，照旧走 malloc
+
+enum class HugePageMode {
+    None,        // 普通 4KB 页，只用 mmap
+    Transparent, // MADV_HUGEPAGE，THP 关掉时退化成普通页
+    HugeTLB,     // MAP_HUGETLB，没有预留大页时退化成 Transparent
+};
+
+enum class NumaPolicy {
+    Default,    // 首次访问（first touch）的线程在哪个节点就分到哪个节点
+    Interleave, // 按页轮流分到所有节点上
+    Bind,       // 只从指定的节点分配
+};
+
+namespace hugepage_detail {
+
+inline constexpr size_t kHugePage = 2 << 20;
+
+// mbind 的 mode，和 <numaif.h> 里的一致；直接走系统调用，不依赖 libnuma
+inline constexpr int kMpolBind = 2;
+inline constexpr int kMpolInterleave = 3;
+
+inline size_t round_up(size_t n, size_t align) noexcept {
+    return (n + align - 1) & ~(align - 1);
+}
+
+// /sys/devices/system/node 下的 nodeN 个数，读不到时当作只有一个节点
+inline unsigned numa_node_count() {
+    static unsigned count = [] {
+        unsigned n = 0;
+        if (DIR *d = opendir("/sys/devices/system/node")) {
+            while (dirent *e = readdir(d)) {
+                std::string name = e->d_name;
+                if (name.size() > 4 && name.compare(0, 4, "node") == 0 && std::isdigit((unsigned char)name[4]))
+                    n++;
+            }
+            closedir(d);
+        }
+        return n ? n : 1u;
+    }();
+    return count;
+}
+
+inline void apply_numa(void *p, size_t bytes, NumaPolicy policy, unsigned node) noexcept {
+    if (policy == NumaPolicy::Default)
+        return;
+    unsigned long mask = 0;
+    int mode;
+    if (policy == NumaPolicy::Interleave) {
+        unsigned nodes = std::min<unsigned>(numa_node_count(), sizeof(mask) * 8);
+        if (nodes < 2)
+            return;
+        mask = nodes == sizeof(mask) * 8 ? ~0ul : (1ul << nodes) - 1;
+        mode = kMpolInterleave;
+    } else {
+        mask = 1ul << (node % (sizeof(mask) * 8));
+        mode = kMpolBind;
+    }
+    // 失败（比如内核没开 NUMA）时只是失去这个优化，不影响正确性
+    syscall(SYS_mbind, p, bytes, mode, &mask, sizeof(mask) * 8 + 1, 0);
+}
+
+// 多映射 2MB 再把两头多余的部分 munmap 掉，得到 2MB 对齐的区域，THP 才能整页映射
+inline void *map_trimmed(size_t bytes, int prot) {
+    size_t span = bytes + kHugePage;
+    void *raw = mmap(nullptr, span, prot, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) [[unlikely]]
+        throw std::bad_alloc();
+    uintptr_t begin = (uintptr_t)raw;
+    uintptr_t aligned = round_up(begin, kHugePage);
+    if (aligned != begin)
+        munmap(raw, aligned - begin);
+    if (uintptr_t end = begin + span, used = aligned + bytes; end != used)
+        munmap((void *)used, end - used);
+    return (void *)aligned;
+}
+
+inline void *map_aligned(size_t bytes, HugePageMode mode) {
+    if (mode == HugePageMode::HugeTLB) {
+        void *p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED)
+            return p;
+        mode = HugePageMode::Transparent;
+    }
+    void *p = map_trimmed(bytes, PROT_READ | PROT_WRITE);
+    if (mode == HugePageMode::Transparent)
+        madvise(p, bytes, MADV_HUGEPAGE);
+    return p;
+}
+
+// 把映射扩到 new_len 并保持 2MB 对齐：先试原地扩展；放不下时先占一块对齐的空位（PROT_NONE，不占内存），
+// 再用 MREMAP_FIXED 把整个映射搬过去。让内核自己挑地址（MREMAP_MAYMOVE）时新地址不一定对齐，
+// 增长过的 Vector 就会失去大部分大页。madvise / mbind 的设置属于映射本身，跟着一起搬，扩出来的部分也继承
+inline void *remap_aligned(void *p, size_t old_len, size_t new_len) {
+    void *q = mremap(p, old_len, new_len, 0);
+    if (q != MAP_FAILED)
+        return q;
+    void *dst = map_trimmed(new_len, PROT_NONE);
+    q = mremap(p, old_len, new_len, MREMAP_MAYMOVE | MREMAP_FIXED, dst);
+    if (q == MAP_FAILED) [[unlikely]] {
+        munmap(dst, new_len);
+        throw std::bad_alloc();
+    }
+    return q;
+}
+
+} // namespace hugepage_detail
+
+template <class T>
+struct HugePageAllocator {
+    using value_type = T;
+    // 内存怎么释放只取决于大小，和策略无关，任何两个实例都能互相释放
+    using is_always_equal = std::true_type;
+
+    static constexpr size_t kMinBytes = 1 << 20;
+
+    HugePageMode m_mode = HugePageMode::Transparent;
+    NumaPolicy m_numa = NumaPolicy::Default;
+    unsigned m_node = 0;
+
+    HugePageAllocator() = default;
+
+    explicit HugePageAllocator(HugePageMode mode, NumaPolicy numa = NumaPolicy::Default, unsigned node = 0) noexcept
+        : m_mode(mode), m_numa(numa), m_node(node) {}
+
+    template <class U>
+    HugePageAllocator(HugePageAllocator<U> const &other) noexcept
+        : m_mode(other.m_mode), m_numa(other.m_numa), m_node(other.m_node) {}
+
+    T *allocate(size_t n) {
+        if (n > (std::numeric_limits<size_t>::max() - 2 * hugepage_detail::kHugePage) / sizeof(T)) [[unlikely]]
+            throw std::bad_array_new_length();
+        size_t bytes = n * sizeof(T);
+        if (!is_mapped(bytes))
+            return small_allocate(bytes);
+        bytes = mapped_size(bytes);
+        void *p = hugepage_detail::map_aligned(bytes, m_mode);
+        hugepage_detail::apply_numa(p, bytes, m_numa, m_node);
+        return static_cast<T *>(p);
+    }
+
+    void deallocate(T *p, size_t n) noexcept {
+        size_t bytes = n * sizeof(T);
+        if (!is_mapped(bytes)) {
+            small_deallocate(p);
+            return;
+        }
+        munmap(p, mapped_size(bytes));
+    }
+
+    // 两边都是 mmap 出来的就用 mremap，内核只改页表不拷数据，新地址仍然 2MB 对齐
+    T *reallocate(T *p, size_t n, size_t new_n) {
+        if (!p)
+            return allocate(new_n);
+        size_t bytes = n * sizeof(T), new_bytes = new_n * sizeof(T);
+        if (is_mapped(bytes) && is_mapped(new_bytes) && m_mode != HugePageMode::HugeTLB)
+            return static_cast<T *>(hugepage_detail::remap_aligned(p, mapped_size(bytes), mapped_size(new_bytes)));
+        T *q = allocate(new_n);
+        std::copy_n(reinterpret_cast<unsigned char *>(p), std::min(bytes, new_bytes),
+                    reinterpret_cast<unsigned char *>(q));
+        deallocate(p, n);
+        return q;
+    }
+
+    friend bool operator==(HugePageAllocator const &, HugePageAllocator const &) noexcept {
+        return true;
+    }
+
+private:
+    static bool is_mapped(size_t bytes) noexcept {
+        return bytes >= kMinBytes;
+    }
+
+    // 映射的长度按大页取整，mremap / munmap 时也用同样的长度
+    static size_t mapped_size(size_t bytes) noexcept {
+        return hugepage_detail::round_up(bytes, hugepage_detail::kHugePage);
+    }
+
+    static T *small_allocate(size_t bytes) {
+        void *p = alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__
+            ? ::operator new(bytes, std::align_val_t(alignof(T)))
+            : std::malloc(bytes ? bytes : 1);
+        if (!p) [[unlikely]]
+            throw std::bad_alloc();
+        return static_cast<T *>(p);
+    }
+
+    static void small_deallocate(T *p) noexcept {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            ::operator delete(p, std::align_val_t(alignof(T)));
+        else
+            std::free(p);
+    }
+};
+
+// 由线程池里的各个线程按块写零，每一页都由之后处理这一块的线程第一次触碰，
+// 在 NumaPolicy::Default 下页面就分配在那个线程所在的节点上；块的划分要和之后计算时的划分一致
+inline void parallel_first_touch(WorkStealingPool &pool, void *p, size_t bytes, size_t grain = 0) {
+    auto *c = static_cast<unsigned char *>(p);
+    if (grain == 0)
+        grain = std::max<size_t>(hugepage_detail::round_up(bytes / pool.size(), 4096), 4096);
+    pool.parallel_for(bytes, grain, [&](size_t begin, size_t end, unsigned) {
+        std::fill(c + begin, c + end, (unsigned char)0);
+    });
+}
@@ -0,0 +1,267 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include "thread_pool.hpp"
+#include "vector.hpp"
+
+// 接受 Vector / Array 迭代器（任意随机访问迭代器）的并行算法，都跑在 WorkStealingPool 上
+// grain 是每个任务处理的元素个数，传 0 时按线程数自动选
+// 叶子任务在连续内存上退化成裸指针循环，让编译器能自动向量化
+
+namespace parallel_detail {
+
+// 每线程大约 8 块，负载不均时有东西可偷；块太小时调度开销盖过计算
+inline size_t auto_grain(WorkStealingPool &pool, size_t n, size_t grain) {
+    if (grain)
+        return grain;
+    return std::max<size_t>(n / ((size_t)pool.size() * 8), 4096);
+}
+
+// 只由 n 决定的块长：块的划分（也就是浮点部分和的结合方式）不随线程数变化；256 块够 32 个线程各分 8 块
+inline size_t fixed_grain(size_t n, size_t grain) {
+    if (grain)
+        return grain;
+    return std::max<size_t>(n / 256, 4096);
+}
+
+// 连续迭代器换成裸指针，其他迭代器原样返回
+template <class It>
+auto raw(It it) {
+    if constexpr (std::contiguous_iterator<It>)
+        return std::to_address(it);
+    else
+        return it;
+}
+
+// 打断 init = op(init, x) 的依赖链：W 个独立的累加器，编译器可以把它们放进一个 SIMD 寄存器
+template <class It, class T, class Op>
+T leaf_reduce(It first, size_t n, T init, Op &op) {
+    constexpr size_t W = 8;
+    if constexpr (std::is_arithmetic_v<T> && std::is_arithmetic_v<std::iter_value_t<It>>) {
+        if (n >= 2 * W) {
+            T acc[W];
+            for (size_t k = 0; k < W; k++)
+                acc[k] = T(first[k]);
+            size_t i = W;
+            for (; i + W <= n; i += W)
+                for (size_t k = 0; k < W; k++)
+                    acc[k] = op(acc[k], first[i + k]);
+            for (size_t k = 0; k < W; k++)
+                init = op(init, acc[k]);
+            for (; i < n; i++)
+                init = op(init, first[i]);
+            return init;
+        }
+    }
+    for (size_t i = 0; i < n; i++)
+        init = op(std::move(init), first[i]);
+    return init;
+}
+
+// 稳定归并 a[0, m) 和 b[0, l) 时，输出的前 k 个里有几个来自 a（相等时 a 在前）
+template <class A, class B, class Comp>
+size_t co_rank(size_t k, A a, size_t m, B b, size_t l, Comp &comp) {
+    size_t lo = k > l ? k - l : 0;
+    size_t hi = std::min(k, m);
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        if (!comp(b[k - i - 1], a[i]))
+            lo = i + 1;
+        else
+            hi = i;
+    }
+    return lo;
+}
+
+// 把已按 width 分段排好序的 src 两两归并到 dst；输出按 grain 切块，每块用 co_rank 找到各自的输入区间
+// width 是 grain 的整数倍，所以一个输出块不会跨两对
+// 归并时会把 src 的元素移走，所以所有切分点要先单独算完一遍，不能边归并边找
+template <class S, class D, class Comp>
+void merge_round(WorkStealingPool &pool, S src, D dst, size_t n, size_t width, size_t grain,
+                 Comp &comp, std::vector<size_t> &split) {
+    size_t npieces = (n + grain - 1) / grain;
+    split.resize(npieces);
+    auto pair_of = [&](size_t begin, size_t &lo, size_t &mid, size_t &hi) {
+        lo = begin / (2 * width) * (2 * width);
+        mid = std::min(lo + width, n);
+        hi = std::min(lo + 2 * width, n);
+    };
+    pool.parallel_for(npieces, 64, [&](size_t cbeg, size_t cend, unsigned) {
+        for (size_t c = cbeg; c < cend; c++) {
+            size_t lo, mid, hi;
+            pair_of(c * grain, lo, mid, hi);
+            split[c] = co_rank(c * grain - lo, src + lo, mid - lo, src + mid, hi - mid, comp);
+        }
+    });
+    pool.parallel_for(n, grain, [&](size_t begin, size_t end, unsigned) {
+        size_t lo, mid, hi;
+        pair_of(begin, lo, mid, hi);
+        size_t c = begin / grain;
+        size_t i0 = split[c];
+        size_t i1 = end == hi ? mid - lo : split[c + 1];
+        size_t j0 = begin - lo - i0, j1 = end - lo - i1;
+        auto a = src + lo;
+        auto b = src + mid;
+        std::merge(std::make_move_iterator(a + i0), std::make_move_iterator(a + i1),
+                   std::make_move_iterator(b + j0), std::make_move_iterator(b + j1),
+                   dst + begin, comp);
+    });
+}
+
+} // namespace parallel_detail
+
+template <std::random_access_iterator It, class Func>
+void parallel_for_each(WorkStealingPool &pool, It first, It last, Func func, size_t grain = 0) {
+    size_t n = last - first;
+    grain = parallel_detail::auto_grain(pool, n, grain);
+    auto p = parallel_detail::raw(first);
+    pool.parallel_for(n, grain, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; i++)
+            func(p[i]);
+    });
+}
+
+// out 可以就是 first（原地变换）
+template <std::random_access_iterator It, std::random_access_iterator Out, class Func>
+Out parallel_transform(WorkStealingPool &pool, It first, It last, Out out, Func func, size_t grain = 0) {
+    size_t n = last - first;
+    grain = parallel_detail::auto_grain(pool, n, grain);
+    auto p = parallel_detail::raw(first);
+    auto q = parallel_detail::raw(out);
+    pool.parallel_for(n, grain, [&](size_t begin, size_t end, unsigned) {
+        for (size_t i = begin; i < end; i++)
+            q[i] = func(p[i]);
+    });
+    return out + n;
+}
+
+// 和 std::reduce 一样，op 要满足结合律和交换律；各块的部分和按块号顺序合并，
+// 块长（默认的也是）只取决于 n 和 grain，所以浮点结果与线程数、调度都无关
+template <std::random_access_iterator It, class T, class Op = std::plus<>>
+T parallel_reduce(WorkStealingPool &pool, It first, It last, T init, Op op = {}, size_t grain = 0) {
+    size_t n = last - first;
+    if (n == 0)
+        return init;
+    grain = parallel_detail::fixed_grain(n, grain);
+    size_t nchunks = (n + grain - 1) / grain;
+    auto p = parallel_detail::raw(first);
+    std::vector<T> partial(nchunks, init);
+    pool.parallel_for(n, grain, [&](size_t begin, size_t end, unsigned) {
+        partial[begin / grain] = parallel_detail::leaf_reduce(p + begin + 1, end - begin - 1, T(p[begin]), op);
+    });
+    for (auto &x: partial)
+        init = op(std::move(init), std::move(x));
+    return init;
+}
+
+// 三遍：各块求和、块和做串行的前缀和、各块带着偏移量做前缀和；op 只要满足结合律
+// out 可以就是 first
+template <std::random_access_iterator It, std::random_access_iterator Out, class Op = std::plus<>>
+Out parallel_inclusive_scan(WorkStealingPool &pool, It first, It last, Out out, Op op = {}, size_t grain = 0) {
+    using T = std::iter_value_t<It>;
+    size_t n = last - first;
+    if (n == 0)
+        return out;
+    grain = parallel_detail::auto_grain(pool, n, grain);
+    size_t nchunks = (n + grain - 1) / grain;
+    auto p = parallel_detail::raw(first);
+    auto q = parallel_detail::raw(out);
+    if (nchunks == 1) {
+        std::inclusive_scan(first, last, out, op);
+        return out + n;
+    }
+    // 最后一块的和用不上，不用算
+    std::vector<T> sums(nchunks);
+    pool.parallel_for(n - (n - 1) % grain - 1, grain, [&](size_t begin, size_t end, unsigned) {
+        sums[begin / grain] = parallel_detail::leaf_reduce(p + begin + 1, end - begin - 1, T(p[begin]), op);
+    });
+    for (size_t c = 1; c < nchunks - 1; c++)
+        sums[c] = op(sums[c - 1], sums[c]);
+    pool.parallel_for(n, grain, [&](size_t begin, size_t end, unsigned) {
+        size_t c = begin / grain;
+        T acc = c ? op(sums[c - 1], p[begin]) : T(p[begin]);
+        q[begin] = acc;
+        for (size_t i = begin + 1; i < end; i++) {
+            acc = op(acc, p[i]);
+            q[i] = acc;
+        }
+    });
+    return out + n;
+}
+
+// 各块先用 std::sort 排好，再一轮轮两两归并（每轮内部按输出位置切块并行），在原数组和缓冲区之间来回倒
+// 元素要能默认构造（缓冲区是 Vector(n, default_init)）
+template <std::random_access_iterator It, class Comp = std::less<>>
+void parallel_sort(WorkStealingPool &pool, It first, It last, Comp comp = {}, size_t grain = 0) {
+    using T = std::iter_value_t<It>;
+    size_t n = last - first;
+    grain = parallel_detail::auto_grain(pool, n, grain);
+    if (n <= grain || pool.size() == 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+    pool.parallel_for(n, grain, [&](size_t begin, size_t end, unsigned) {
+        std::sort(first + begin, first + end, comp);
+    });
+    Vector<T> buf(n, default_init);
+    auto a = parallel_detail::raw(first);
+    T *b = buf.data();
+    std::vector<size_t> split;
+    bool in_buf = false;
+    for (size_t width = grain; width < n; width *= 2) {
+        if (in_buf)
+            parallel_detail::merge_round(pool, b, a, n, width, grain, comp, split);
+        else
+            parallel_detail::merge_round(pool, a, b, n, width, grain, comp, split);
+        in_buf = !in_buf;
+    }
+    if (in_buf) {
+        pool.parallel_for(n, grain, [&](size_t begin, size_t end, unsigned) {
+            std::move(b + begin, b + end, a + begin);
+        });
+    }
+}
+
+// 稳定划分：各块数满足 pred 的个数，前缀和得到每块的写入位置，分散到缓冲区再搬回来
+// 返回第一个不满足 pred 的位置；元素要能默认构造
+template <std::random_access_iterator It, class Pred>
+It parallel_partition(WorkStealingPool &pool, It first, It last, Pred pred, size_t grain = 0) {
+    using T = std::iter_value_t<It>;
+    size_t n = last - first;
+    grain = parallel_detail::auto_grain(pool, n, grain);
+    size_t nchunks = (n + grain - 1) / grain;
+    auto p = parallel_detail::raw(first);
+    std::vector<size_t> ntrue(nchunks + 1);
+    pool.parallel_for(n, grain, [&](size_t begin, size_t end, unsigned) {
+        size_t k = 0;
+        for (size_t i = begin; i < end; i++)
+            k += (bool)pred(p[i]);
+        ntrue[begin / grain + 1] = k;
+    });
+    for (size_t c = 0; c < nchunks; c++)
+        ntrue[c + 1] += ntrue[c];
+    size_t total = ntrue[nchunks];
+    Vector<T> buf(n, default_init);
+    T *b = buf.data();
+    pool.parallel_for(n, grain, [&](size_t begin, size_t end, unsigned) {
+        size_t c = begin / grain;
+        // 这一块之前的 false 个数 = begin - 之前的 true 个数
+        size_t t = ntrue[c], f = total + begin - ntrue[c];
+        for (size_t i = begin; i < end; i++) {
+            if (pred(p[i]))
+                b[t++] = std::move(p[i]);
+            else
+                b[f++] = std::move(p[i]);
+        }
+    });
+    pool.parallel_for(n, grain, [&](size_t begin, size_t end, unsigned) {
+        std::move(b + begin, b + end, p + begin);
+    });
+    return first + total;
+}
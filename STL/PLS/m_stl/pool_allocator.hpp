@@ -0,0 +1,133 @@
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+
+// 按大小分级的内存池：8, 16, 32 ... 4096 字节各一条空闲链表，从 64KB 的大块里切（对齐最多到 max_align_t）；
+// 超过 4096 字节的直接走 malloc。释放的块挂回对应的链表，下次同级的分配直接复用
+// 不是线程安全的，每个线程用自己的 PoolResource
+struct PoolResource {
+    static constexpr size_t kMinShift = 3;
+    static constexpr size_t kMaxShift = 12;
+    static constexpr size_t kNumClasses = kMaxShift - kMinShift + 1;
+    static constexpr size_t kSlabSize = 64 << 10;
+
+    PoolResource() = default;
+    PoolResource(PoolResource const &) = delete;
+    PoolResource &operator=(PoolResource const &) = delete;
+
+    ~PoolResource() {
+        while (m_slabs) {
+            Slab *next = m_slabs->next;
+            std::free(m_slabs);
+            m_slabs = next;
+        }
+    }
+
+    void *allocate(size_t bytes, size_t align) {
+        size_t c = size_class(bytes);
+        if (c >= kNumClasses || align > alignof(std::max_align_t)) [[unlikely]]
+            return big_allocate(bytes, align);
+        if (FreeBlock *b = m_free[c]) [[likely]] {
+            m_free[c] = b->next;
+            return b;
+        }
+        return refill(c);
+    }
+
+    void deallocate(void *p, size_t bytes, size_t align) noexcept {
+        size_t c = size_class(bytes);
+        if (c >= kNumClasses || align > alignof(std::max_align_t)) [[unlikely]] {
+            big_deallocate(p, align);
+            return;
+        }
+        auto *b = static_cast<FreeBlock *>(p);
+        b->next = m_free[c];
+        m_free[c] = b;
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    struct alignas(std::max_align_t) Slab {
+        Slab *next;
+    };
+
+    static constexpr size_t class_size(size_t c) noexcept {
+        return (size_t)1 << (c + kMinShift);
+    }
+
+    // 向上取整到 2 的幂后的级别
+    static size_t size_class(size_t bytes) noexcept {
+        if (bytes <= ((size_t)1 << kMinShift))
+            return 0;
+        return (size_t)(64 - __builtin_clzll(bytes - 1)) - kMinShift;
+    }
+
+    void *refill(size_t c) {
+        auto *slab = static_cast<Slab *>(std::malloc(kSlabSize));
+        if (!slab) [[unlikely]]
+            throw std::bad_alloc();
+        slab->next = m_slabs;
+        m_slabs = slab;
+        // slab 头之后的部分切成等大的块，第一块直接返回，其余挂进空闲链表
+        size_t size = class_size(c);
+        char *begin = reinterpret_cast<char *>(slab + 1);
+        char *end = reinterpret_cast<char *>(slab) + kSlabSize;
+        for (char *p = begin + size; p + size <= end; p += size) {
+            auto *b = reinterpret_cast<FreeBlock *>(p);
+            b->next = m_free[c];
+            m_free[c] = b;
+        }
+        return begin;
+    }
+
+    static void *big_allocate(size_t bytes, size_t align) {
+        if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            return ::operator new(bytes, std::align_val_t(align));
+        void *p = std::malloc(bytes);
+        if (!p) [[unlikely]]
+            throw std::bad_alloc();
+        return p;
+    }
+
+    static void big_deallocate(void *p, size_t align) noexcept {
+        if (align > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            ::operator delete(p, std::align_val_t(align));
+        else
+            std::free(p);
+    }
+
+    FreeBlock *m_free[kNumClasses] = {};
+    Slab *m_slabs = nullptr;
+};
+
+template <class T>
+struct PoolAllocator {
+    using value_type = T;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    PoolResource *m_pool;
+
+    explicit PoolAllocator(PoolResource &pool) noexcept : m_pool(&pool) {}
+
+    template <class U>
+    PoolAllocator(PoolAllocator<U> const &other) noexcept : m_pool(other.m_pool) {}
+
+    T *allocate(size_t n) {
+        return static_cast<T *>(m_pool->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T *p, size_t n) noexcept {
+        m_pool->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    friend bool operator==(PoolAllocator const &a, PoolAllocator const &b) noexcept {
+        return a.m_pool == b.m_pool;
+    }
+};
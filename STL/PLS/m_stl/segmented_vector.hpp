@@ -0,0 +1,341 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "allocator.hpp"
+
+// 由一串大小翻倍的段组成：第 k 段有 B << k 个元素，前 k 段一共 B * (2^k - 1) 个
+// 扩容只是多分配一段，已有的元素从不搬家，元素地址在容器的整个生命期里都不变
+// 下标 i 所在的段号和段内偏移用一次 bit_width（最高位的位置）算出来，O(1)
+// push_back / emplace_back 是单线程的；concurrent_emplace_back 可以多个线程同时调用，
+// 各自用 CAS 预定一个位置，但读者要等所有写者结束（比如 join 之后）才能看到完整的内容
+template <class T, size_t B = 64>
+struct SegmentedVector {
+    static_assert(B > 0 && (B & (B - 1)) == 0, "first segment size must be a power of two");
+
+    using value_type = T;
+
+    static constexpr size_t kLogB = std::countr_zero(B);
+    static constexpr size_t kMaxSegments = sizeof(size_t) * 8 - kLogB;
+
+    SegmentedVector() noexcept = default;
+
+    SegmentedVector(SegmentedVector const &) = delete;
+    SegmentedVector &operator=(SegmentedVector const &) = delete;
+
+    SegmentedVector(SegmentedVector &&other) noexcept {
+        steal(other);
+    }
+
+    SegmentedVector &operator=(SegmentedVector &&other) noexcept {
+        if (this != &other) {
+            clear();
+            free_segments();
+            steal(other);
+        }
+        return *this;
+    }
+
+    ~SegmentedVector() {
+        clear();
+        free_segments();
+    }
+
+    // 下标 i 所在的段号：(i / B + 1) 的最高位
+    static constexpr size_t segment_of(size_t i) noexcept {
+        return std::bit_width((i >> kLogB) + 1) - 1;
+    }
+
+    static constexpr size_t segment_begin(size_t k) noexcept {
+        return (((size_t)1 << k) - 1) << kLogB;
+    }
+
+    static constexpr size_t segment_size(size_t k) noexcept {
+        return B << k;
+    }
+
+    size_t size() const noexcept {
+        return m_size.load(std::memory_order_relaxed);
+    }
+
+    bool empty() const noexcept {
+        return size() == 0;
+    }
+
+    // 已经分配好的段能装多少个
+    size_t capacity() const noexcept {
+        return segment_begin(m_nsegs.load(std::memory_order_relaxed));
+    }
+
+    T &operator[](size_t i) noexcept {
+        size_t k = segment_of(i);
+        return m_segs[k].load(std::memory_order_relaxed)[i - segment_begin(k)];
+    }
+
+    T const &operator[](size_t i) const noexcept {
+        size_t k = segment_of(i);
+        return m_segs[k].load(std::memory_order_relaxed)[i - segment_begin(k)];
+    }
+
+    T &at(size_t i) {
+        if (i >= size()) [[unlikely]]
+            throw std::out_of_range("segmented_vector::at");
+        return (*this)[i];
+    }
+
+    T const &at(size_t i) const {
+        if (i >= size()) [[unlikely]]
+            throw std::out_of_range("segmented_vector::at");
+        return (*this)[i];
+    }
+
+    T &front() noexcept {
+        return (*this)[0];
+    }
+
+    T &back() noexcept {
+        return (*this)[size() - 1];
+    }
+
+    // 预先把能装下 n 个元素的段都分配好
+    void reserve(size_t n) {
+        if (n == 0)
+            return;
+        size_t last = segment_of(n - 1);
+        for (size_t k = 0; k <= last; k++)
+            ensure_segment(k);
+    }
+
+    void push_back(T const &val) {
+        emplace_back(val);
+    }
+
+    void push_back(T &&val) {
+        emplace_back(std::move(val));
+    }
+
+    template <class ...Args>
+    T &emplace_back(Args &&...args) {
+        size_t i = m_size.load(std::memory_order_relaxed);
+        // 大多数时候还在上次那一段里，不用重新算段号、读段表
+        T *p = i - m_tail_begin < m_tail_size ? m_tail_seg + (i - m_tail_begin) : tail_slot(i);
+        ::new ((void *)p) T(std::forward<Args>(args)...);
+        m_size.store(i + 1, std::memory_order_relaxed);
+        return *p;
+    }
+
+    // 可以和其他线程的 concurrent_emplace_back 同时调用，返回这个元素的下标
+    // 不能和 emplace_back / pop_back / clear 等单线程的修改同时调用
+    // size() 一加上就算作已构造，clear() 和析构都会去销毁它，所以加之前不能再有任何会抛异常的步骤：
+    // 先把段分配好再用 CAS 预定下标（分配失败时容器不变），构造也必须 noexcept
+    template <class ...Args>
+    size_t concurrent_emplace_back(Args &&...args) {
+        static_assert(std::is_nothrow_constructible_v<T, Args &&...>,
+                      "construct the element outside and pass it in with std::move");
+        size_t i = m_size.load(std::memory_order_relaxed);
+        T *p;
+        do {
+            p = slot(i);
+        } while (!m_size.compare_exchange_weak(i, i + 1, std::memory_order_relaxed));
+        ::new ((void *)p) T(std::forward<Args>(args)...);
+        return i;
+    }
+
+    void pop_back() noexcept {
+        size_t i = size() - 1;
+        std::destroy_at(&(*this)[i]);
+        m_size.store(i, std::memory_order_relaxed);
+    }
+
+    // 只析构元素，段留着给下一轮用
+    void clear() noexcept {
+        size_t n = size();
+        for (size_t k = 0; segment_begin(k) < n; k++) {
+            T *seg = m_segs[k].load(std::memory_order_relaxed);
+            std::destroy(seg, seg + std::min(segment_size(k), n - segment_begin(k)));
+        }
+        m_size.store(0, std::memory_order_relaxed);
+    }
+
+    // 对每一段里的元素连续地调用 func(T *first, T *last)，比按下标逐个访问少了每次的段号计算
+    template <class Func>
+    void for_each_segment(Func &&func) {
+        size_t n = size();
+        for (size_t k = 0; segment_begin(k) < n; k++) {
+            T *seg = m_segs[k].load(std::memory_order_relaxed);
+            func(seg, seg + std::min(segment_size(k), n - segment_begin(k)));
+        }
+    }
+
+    template <bool Const>
+    struct basic_iterator {
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using owner_type = std::conditional_t<Const, SegmentedVector const, SegmentedVector>;
+        using reference = std::conditional_t<Const, T const &, T &>;
+        using pointer = std::conditional_t<Const, T const *, T *>;
+
+        owner_type *m_owner = nullptr;
+        size_t m_index = 0;
+
+        reference operator*() const noexcept {
+            return (*m_owner)[m_index];
+        }
+
+        pointer operator->() const noexcept {
+            return &(*m_owner)[m_index];
+        }
+
+        reference operator[](difference_type n) const noexcept {
+            return (*m_owner)[m_index + n];
+        }
+
+        basic_iterator &operator++() noexcept {
+            ++m_index;
+            return *this;
+        }
+
+        basic_iterator operator++(int) noexcept {
+            auto old = *this;
+            ++m_index;
+            return old;
+        }
+
+        basic_iterator &operator--() noexcept {
+            --m_index;
+            return *this;
+        }
+
+        basic_iterator operator--(int) noexcept {
+            auto old = *this;
+            --m_index;
+            return old;
+        }
+
+        basic_iterator &operator+=(difference_type n) noexcept {
+            m_index += n;
+            return *this;
+        }
+
+        basic_iterator &operator-=(difference_type n) noexcept {
+            m_index -= n;
+            return *this;
+        }
+
+        friend basic_iterator operator+(basic_iterator it, difference_type n) noexcept {
+            return it += n;
+        }
+
+        friend basic_iterator operator+(difference_type n, basic_iterator it) noexcept {
+            return it += n;
+        }
+
+        friend basic_iterator operator-(basic_iterator it, difference_type n) noexcept {
+            return it -= n;
+        }
+
+        friend difference_type operator-(basic_iterator const &a, basic_iterator const &b) noexcept {
+            return (difference_type)a.m_index - (difference_type)b.m_index;
+        }
+
+        friend bool operator==(basic_iterator const &a, basic_iterator const &b) noexcept {
+            return a.m_index == b.m_index;
+        }
+
+        friend auto operator<=>(basic_iterator const &a, basic_iterator const &b) noexcept {
+            return a.m_index <=> b.m_index;
+        }
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    iterator begin() noexcept {
+        return {this, 0};
+    }
+
+    iterator end() noexcept {
+        return {this, size()};
+    }
+
+    const_iterator begin() const noexcept {
+        return {this, 0};
+    }
+
+    const_iterator end() const noexcept {
+        return {this, size()};
+    }
+
+private:
+    // 第 i 个位置的地址，所在的段还没分配就分配
+    T *slot(size_t i) {
+        size_t k = segment_of(i);
+        T *seg = m_segs[k].load(std::memory_order_acquire);
+        if (!seg) [[unlikely]]
+            seg = ensure_segment(k);
+        return seg + (i - segment_begin(k));
+    }
+
+    // 单线程追加时换到新的一段，顺便记下这一段的位置
+    T *tail_slot(size_t i) {
+        T *p = slot(i);
+        size_t k = segment_of(i);
+        m_tail_seg = m_segs[k].load(std::memory_order_relaxed);
+        m_tail_begin = segment_begin(k);
+        m_tail_size = segment_size(k);
+        return p;
+    }
+
+    // 多个线程同时发现缺同一段时，各自分配，用 CAS 决出一个，输的把自己的释放掉
+    T *ensure_segment(size_t k) {
+        T *seg = m_segs[k].load(std::memory_order_acquire);
+        if (seg)
+            return seg;
+        T *fresh = MallocAllocator<T>().allocate(segment_size(k));
+        if (m_segs[k].compare_exchange_strong(seg, fresh, std::memory_order_acq_rel)) {
+            size_t n = m_nsegs.load(std::memory_order_relaxed);
+            while (n < k + 1 && !m_nsegs.compare_exchange_weak(n, k + 1, std::memory_order_relaxed))
+                ;
+            return fresh;
+        }
+        MallocAllocator<T>().deallocate(fresh, segment_size(k));
+        return seg;
+    }
+
+    void free_segments() noexcept {
+        for (size_t k = 0; k < kMaxSegments; k++) {
+            if (T *seg = m_segs[k].exchange(nullptr, std::memory_order_relaxed))
+                MallocAllocator<T>().deallocate(seg, segment_size(k));
+        }
+        m_nsegs.store(0, std::memory_order_relaxed);
+        m_tail_seg = nullptr;
+        m_tail_begin = m_tail_size = 0;
+    }
+
+    void steal(SegmentedVector &other) noexcept {
+        for (size_t k = 0; k < kMaxSegments; k++)
+            m_segs[k].store(other.m_segs[k].exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+        m_size.store(other.m_size.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        m_nsegs.store(other.m_nsegs.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        m_tail_seg = std::exchange(other.m_tail_seg, nullptr);
+        m_tail_begin = std::exchange(other.m_tail_begin, 0);
+        m_tail_size = std::exchange(other.m_tail_size, 0);
+    }
+
+    std::atomic<T *> m_segs[kMaxSegments] = {};
+    std::atomic<size_t> m_size{0};
+    std::atomic<size_t> m_nsegs{0};
+    // emplace_back 上次用的那一段；段从不搬家，只在释放所有段时清掉
+    T *m_tail_seg = nullptr;
+    size_t m_tail_begin = 0;
+    size_t m_tail_size = 0;
+};
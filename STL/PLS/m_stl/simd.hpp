@@ -0,0 +1,88 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include "allocator.hpp"
+#include "array.hpp"
+#include "vector.hpp"
+
+// 元素按 Align 对齐、首地址也按 Align 对齐的 Vector，容量后面总有补齐到 Align 字节的空间
+template <class T, size_t Align = 64>
+using AlignedVector = Vector<T, AlignedAllocator<T, Align>>;
+
+// 按 SIMD 宽度（Align 字节，即 lanes 个元素）分块访问一段对齐的内存
+// size() 已经向上补齐到 lanes 的整数倍，补出来的元素由 make_simd_view 填好，读它们是安全的
+template <class T, size_t Align>
+struct simd_view {
+    static constexpr size_t lanes = Align / sizeof(T);
+    using chunk_type = std::span<T, lanes>;
+
+    T *m_data;
+    size_t m_size;
+
+    size_t size() const noexcept {
+        return m_size;
+    }
+
+    size_t nchunks() const noexcept {
+        return m_size / lanes;
+    }
+
+    // 告诉编译器首地址是对齐的，循环里可以直接用对齐的读写指令
+    T *data() const noexcept {
+        return std::assume_aligned<Align>(m_data);
+    }
+
+    chunk_type chunk(size_t i) const noexcept {
+        return chunk_type(data() + i * lanes, lanes);
+    }
+
+    struct iterator {
+        T *p;
+
+        chunk_type operator*() const noexcept {
+            return chunk_type(std::assume_aligned<Align>(p), lanes);
+        }
+
+        iterator &operator++() noexcept {
+            p += lanes;
+            return *this;
+        }
+
+        bool operator!=(iterator const &other) const noexcept {
+            return p != other.p;
+        }
+    };
+
+    iterator begin() const noexcept {
+        return {m_data};
+    }
+
+    iterator end() const noexcept {
+        return {m_data + m_size};
+    }
+};
+
+// 把 size() 之后、补齐之前的元素填成 pad（求和填 0，求积填 1），返回分块视图
+// 之后 push_back 等修改会覆盖补出来的元素，要重新取视图
+template <class T, size_t Align, class Growth>
+simd_view<T, Align> make_simd_view(Vector<T, AlignedAllocator<T, Align>, Growth> &v, T const &pad = T()) {
+    static_assert(std::is_trivially_copyable_v<T>, "padding is written into raw capacity");
+    static_assert(Align % sizeof(T) == 0, "Align must be a multiple of sizeof(T)");
+    constexpr size_t lanes = Align / sizeof(T);
+    size_t padded = (v.size() + lanes - 1) / lanes * lanes;
+    // 容量之外、补齐之内的这段是 AlignedAllocator 多分配出来的原始内存
+    for (size_t i = v.size(); i < padded; i++)
+        ::new ((void *)(v.data() + i)) T(pad);
+    return {v.data(), padded};
+}
+
+template <class T, size_t N, size_t Align>
+simd_view<T, Align> make_simd_view(Array<T, N, Align> &a, T const &pad = T()) {
+    static_assert(Align > alignof(T), "Array needs an explicit Align to be padded");
+    // Array 补出来的元素本来就是构造好的，直接赋值
+    std::fill(a.data() + N, a.data() + a.padded_size, pad);
+    return {a.data(), a.padded_size};
+}
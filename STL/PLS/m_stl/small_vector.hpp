@@ -0,0 +1,386 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include "allocator.hpp"
+#include "growth.hpp"
+#include "vector.hpp"
+
+// 前 N 个元素放在对象内部，超过 N 个才挪到堆上；接口和 Vector 一致
+// 大部分时候只装几个元素的容器用它可以完全不碰 malloc
+template <class T, size_t N = 16>
+struct SmallVector {
+    using value_type = T;
+
+    T *m_data;
+    size_t m_size;
+    size_t m_cap;
+    alignas(T) unsigned char m_inline[N * sizeof(T)];
+
+    SmallVector() noexcept : m_data{inline_data()}, m_size{0}, m_cap{N} {}
+
+    explicit SmallVector(size_t n) : SmallVector() {
+        reserve(n);
+        std::uninitialized_value_construct_n(m_data, n);
+        m_size = n;
+    }
+
+    explicit SmallVector(size_t n, T const &val) : SmallVector() {
+        reserve(n);
+        std::uninitialized_fill_n(m_data, n, val);
+        m_size = n;
+    }
+
+    template <std::random_access_iterator InputIt>
+    SmallVector(InputIt first, InputIt last) : SmallVector() {
+        size_t n = last - first;
+        reserve(n);
+        std::uninitialized_copy(first, last, m_data);
+        m_size = n;
+    }
+
+    SmallVector(std::initializer_list<T> list) : SmallVector(list.begin(), list.end()) {}
+
+    SmallVector(SmallVector const &other) : SmallVector(other.begin(), other.end()) {}
+
+    // 对方在堆上就直接接管那块内存；在内部缓冲区里就只能逐个移动元素
+    SmallVector(SmallVector &&other) noexcept(std::is_nothrow_move_constructible_v<T>) : SmallVector() {
+        take(other);
+    }
+
+    SmallVector &operator=(SmallVector const &other) {
+        if (this != &other)
+            assign(other.begin(), other.end());
+        return *this;
+    }
+
+    SmallVector &operator=(SmallVector &&other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        if (this != &other) {
+            clear();
+            free_heap();
+            take(other);
+        }
+        return *this;
+    }
+
+    ~SmallVector() {
+        clear();
+        free_heap();
+    }
+
+    template <std::random_access_iterator InputIt>
+    void assign(InputIt first, InputIt last) {
+        size_t n = last - first;
+        if (n > m_cap) {
+            clear();
+            reserve(n);
+        }
+        size_t common = std::min(n, m_size);
+        std::copy(first, first + common, m_data);
+        std::uninitialized_copy(first + common, last, m_data + common);
+        destroy_tail(common);
+        m_size = n;
+    }
+
+    void assign(size_t n, T const &val) {
+        if (n > m_cap) {
+            clear();
+            reserve(n);
+        }
+        size_t common = std::min(n, m_size);
+        std::fill_n(m_data, common, val);
+        std::uninitialized_fill(m_data + common, m_data + n, val);
+        destroy_tail(common);
+        m_size = n;
+    }
+
+    void assign(std::initializer_list<T> list) {
+        assign(list.begin(), list.end());
+    }
+
+    void resize(size_t n) {
+        if (n > m_size) {
+            grow(n);
+            std::uninitialized_value_construct(m_data + m_size, m_data + n);
+            m_size = n;
+        } else {
+            destroy_tail(n);
+        }
+    }
+
+    void resize(size_t n, T const &val) {
+        if (n > m_size) {
+            grow(n);
+            std::uninitialized_fill(m_data + m_size, m_data + n, val);
+            m_size = n;
+        } else {
+            destroy_tail(n);
+        }
+    }
+
+    void reserve(size_t n) {
+        if (n <= m_cap) [[likely]]
+            return;
+        relocate_to_heap(n);
+    }
+
+    // 装得下时搬回内部缓冲区
+    void shrink_to_fit() {
+        if (!is_inline() && m_size <= N) {
+            T *old = m_data;
+            size_t old_cap = m_cap;
+            std::uninitialized_move(old, old + m_size, inline_data());
+            std::destroy(old, old + m_size);
+            MallocAllocator<T>().deallocate(old, old_cap);
+            m_data = inline_data();
+            m_cap = N;
+        } else if (!is_inline() && m_cap != m_size) {
+            relocate_to_heap(m_size);
+        }
+    }
+
+    void clear() noexcept {
+        destroy_tail(0);
+    }
+
+    size_t size() const noexcept {
+        return m_size;
+    }
+
+    size_t capacity() const noexcept {
+        return m_cap;
+    }
+
+    bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    // 元素是否还在对象内部
+    bool is_inline() const noexcept {
+        return m_data == inline_data();
+    }
+
+    T *data() noexcept {
+        return m_data;
+    }
+
+    T const *data() const noexcept {
+        return m_data;
+    }
+
+    T const &operator[](size_t i) const noexcept {
+        return m_data[i];
+    }
+
+    T &operator[](size_t i) noexcept {
+        return m_data[i];
+    }
+
+    T const &at(size_t i) const {
+        if (i >= m_size) [[unlikely]]
+            throw std::out_of_range("small_vector::at");
+        return m_data[i];
+    }
+
+    T &at(size_t i) {
+        if (i >= m_size) [[unlikely]]
+            throw std::out_of_range("small_vector::at");
+        return m_data[i];
+    }
+
+    T const &front() const noexcept {
+        return m_data[0];
+    }
+
+    T &front() noexcept {
+        return m_data[0];
+    }
+
+    T const &back() const noexcept {
+        return m_data[m_size - 1];
+    }
+
+    T &back() noexcept {
+        return m_data[m_size - 1];
+    }
+
+    void push_back(T const &val) {
+        emplace_back(val);
+    }
+
+    void push_back(T &&val) {
+        emplace_back(std::move(val));
+    }
+
+    template <class ...Args>
+    T &emplace_back(Args &&...args) {
+        if (m_size == m_cap) [[unlikely]] {
+            // args 可能引用着自己的元素，先构造出来再扩容
+            T tmp(std::forward<Args>(args)...);
+            grow(m_size + 1);
+            ::new ((void *)(m_data + m_size)) T(std::move(tmp));
+        } else {
+            ::new ((void *)(m_data + m_size)) T(std::forward<Args>(args)...);
+        }
+        return m_data[m_size++];
+    }
+
+    void pop_back() noexcept {
+        destroy_tail(m_size - 1);
+    }
+
+    T *begin() noexcept {
+        return m_data;
+    }
+
+    T *end() noexcept {
+        return m_data + m_size;
+    }
+
+    T const *begin() const noexcept {
+        return m_data;
+    }
+
+    T const *end() const noexcept {
+        return m_data + m_size;
+    }
+
+    void erase(size_t i) {
+        erase(i, i + 1);
+    }
+
+    void erase(size_t ibeg, size_t iend) {
+        std::move(m_data + iend, m_data + m_size, m_data + ibeg);
+        destroy_tail(m_size - (iend - ibeg));
+    }
+
+    void erase(T const *it) {
+        erase(it - m_data);
+    }
+
+    void erase(T const *first, T const *last) {
+        erase(first - m_data, last - m_data);
+    }
+
+    void insert(T const *it, size_t n, T val) {
+        insert_n(it - m_data, n, [&](size_t) -> T const & { return val; });
+    }
+
+    template <std::random_access_iterator InputIt>
+    void insert(T const *it, InputIt first, InputIt last) {
+        if constexpr (std::is_pointer_v<InputIt>) {
+            // 源区间就在自己里面时，扩容会让它失效，先拷出来
+            if (std::less_equal<>()(m_data, first) && std::less<>()(first, m_data + m_size)) {
+                SmallVector tmp(first, last);
+                insert(it, tmp.begin(), tmp.end());
+                return;
+            }
+        }
+        insert_n(it - m_data, last - first, [&](size_t k) -> decltype(auto) { return first[k]; });
+    }
+
+    void insert(T const *it, std::initializer_list<T> list) {
+        insert(it, list.begin(), list.end());
+    }
+
+    void swap(SmallVector &other) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        SmallVector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    void print() const noexcept {
+        for (size_t i = 0; i < size(); ++i) {
+            std::cout << m_data[i] << " ";
+        }
+        std::cout << "\n";
+    }
+
+private:
+    T *inline_data() noexcept {
+        return reinterpret_cast<T *>(m_inline);
+    }
+
+    T const *inline_data() const noexcept {
+        return reinterpret_cast<T const *>(m_inline);
+    }
+
+    void grow(size_t need) {
+        if (need <= m_cap) [[likely]]
+            return;
+        relocate_to_heap(GrowDouble::next(m_cap, need, sizeof(T)));
+    }
+
+    // 换到一块恰好 n 个的堆内存上（n >= m_size）
+    void relocate_to_heap(size_t n) {
+        MallocAllocator<T> alloc;
+        if constexpr (is_trivially_relocatable_v<T> && Reallocatable<MallocAllocator<T>>) {
+            if (!is_inline()) {
+                m_data = alloc.reallocate(m_data, m_cap, n);
+                m_cap = n;
+                return;
+            }
+        }
+        T *p = alloc.allocate(n);
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            std::uninitialized_move(m_data, m_data + m_size, p);
+        } else {
+            try {
+                std::uninitialized_copy(m_data, m_data + m_size, p);
+            } catch (...) {
+                alloc.deallocate(p, n);
+                throw;
+            }
+        }
+        std::destroy(m_data, m_data + m_size);
+        free_heap();
+        m_data = p;
+        m_cap = n;
+    }
+
+    void free_heap() noexcept {
+        if (!is_inline())
+            MallocAllocator<T>().deallocate(m_data, m_cap);
+        m_data = inline_data();
+        m_cap = N;
+    }
+
+    // 调用前自己必须是空的、在内部缓冲区上
+    void take(SmallVector &other) {
+        if (other.is_inline()) {
+            std::uninitialized_move(other.begin(), other.end(), m_data);
+            m_size = other.m_size;
+            other.clear();
+        } else {
+            m_data = other.m_data;
+            m_size = other.m_size;
+            m_cap = other.m_cap;
+            other.m_data = other.inline_data();
+            other.m_size = 0;
+            other.m_cap = N;
+        }
+    }
+
+    // 在 j 处插入 n 个元素，第 k 个是 get(k)；get 给出的不能是自己的元素
+    template <class Get>
+    void insert_n(size_t j, size_t n, Get get) {
+        if (n == 0)
+            return;
+        grow(m_size + n);
+        // 和 Vector 共用：中途抛异常时 size 之外构造出来的元素会被销毁
+        vector_detail::insert_shift(m_data, m_size, j, n, get);
+        m_size += n;
+    }
+
+    void destroy_tail(size_t n) noexcept {
+        std::destroy(m_data + n, m_data + m_size);
+        m_size = n;
+    }
+};
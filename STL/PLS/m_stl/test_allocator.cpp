@@ -0,0 +1,42 @@
+#include <iostream>
+#include <string>
+#include "vector.hpp"
+#include "arena.hpp"
+#include "pool_allocator.hpp"
+#include "hugepage_allocator.hpp"
+
+int main() {
+    MonotonicArena arena;
+    Vector<int, ArenaAllocator<int>> a{ArenaAllocator<int>(arena)};
+    for (int i = 0; i < 10; i++)
+        a.push_back(i);
+    a.print();
+    // 最后一块分配原地扩展，地址不变
+    int *before = a.data();
+    a.reserve(100);
+    std::cout << "in place: " << (before == a.data()) << "\n";
+
+    Vector<int, ArenaAllocator<int>> b = a;
+    std::cout << "same arena: " << (b.get_allocator() == a.get_allocator()) << "\n";
+    b.print();
+
+    PoolResource pool;
+    Vector<std::string, PoolAllocator<std::string>> s{PoolAllocator<std::string>(pool)};
+    for (int i = 0; i < 5; i++)
+        s.push_back(std::string(i + 1, 'x'));
+    s.print();
+    auto t = std::move(s);
+    t.erase(t.begin() + 1);
+    t.print();
+    std::cout << "moved-from size: " << s.size() << "\n";
+
+    // 跨过 1MB 时从 malloc 换到 mmap，之后的扩容走 mremap
+    Vector<long, HugePageAllocator<long>> h;
+    for (long i = 0; i < 1000000; i++)
+        h.push_back(i);
+    std::cout << "hugepage vector: " << h.size() << " " << h.back() << "\n";
+
+    arena.reset();
+    std::cout << "arena reserved: " << arena.reserved() << "\n";
+    return 0;
+}
@@ -1,5 +1,6 @@
 #include <iostream>
 #include "array.hpp"
+#include "simd.hpp"
 
 
 int main() {
@@ -19,5 +20,20 @@ int main() {
     for (size_t i = 0; i < a.size(); ++i) {
         std::cout << a[i] << " ";
     }
+    std::cout << "\n";
+    // 10 个 float 按 64 字节对齐，补到 16 个；视图按 16 个一块访问
+    Array<float, 10, 64> f{};
+    for (size_t i = 0; i < f.size(); ++i) {
+        f[i] = (float)i;
+    }
+    auto view = make_simd_view(f, -1.0f);
+    std::cout << sizeof(f) << " " << view.nchunks() << " " << f.data()[15] << "\n";
+    AlignedVector<float> v(20, 1.0f);
+    float sum = 0;
+    for (auto chunk: make_simd_view(v)) {
+        for (float x: chunk)
+            sum += x;
+    }
+    std::cout << ((uintptr_t)v.data() % 64) << " " << sum << "\n";
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include <algorithm>
+#include <atomic>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include "concurrent_vector.hpp"
+
+int main() {
+    ConcurrentVector<std::string, 4> s;
+    for (int i = 0; i < 10; i++)
+        s.push_back(std::to_string(i));
+    auto snap = s.snapshot();
+    std::cout << snap.size() << ": ";
+    for (auto const &x: snap)
+        std::cout << x << " ";
+    std::cout << "\n";
+
+    // 4 个写者同时追加，1 个读者不停地取快照：每个快照里的元素都必须是构造好的
+    ConcurrentVector<long> v;
+    std::atomic<bool> done{false};
+    std::atomic<bool> bad{false};
+    size_t snapshots = 0;
+    std::thread reader([&] {
+        while (!done.load()) {
+            auto snap = v.snapshot();
+            // 元素的值都是正数，没构造好的位置会读到 0 或垃圾
+            snap.for_each_segment([&](long const *first, long const *last) {
+                for (long const *p = first; p != last; p++)
+                    if (*p <= 0)
+                        bad = true;
+            });
+            snapshots++;
+        }
+    });
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; t++) {
+        writers.emplace_back([&v, t] {
+            for (long i = 1; i <= 20000; i++)
+                v.push_back(t * 100000 + i);
+        });
+    }
+    for (auto &w: writers)
+        w.join();
+    done = true;
+    reader.join();
+
+    auto all = v.snapshot();
+    std::vector<long> got(all.begin(), all.end());
+    std::sort(got.begin(), got.end());
+    bool ok = got.size() == 80000 && std::adjacent_find(got.begin(), got.end()) == got.end();
+    std::cout << "concurrent: " << ok << ", snapshots consistent: " << !bad << "\n";
+    (void)snapshots;
+
+    // 段分配失败时还没预定下标：容器不变，published() 不会卡在一个永远不就绪的位置上
+    struct Huge {
+        char bytes[size_t(1) << 40];
+    };
+    ConcurrentVector<Huge> h;
+    bool threw = false;
+    try {
+        h.emplace_back();
+    } catch (std::bad_alloc const &) {
+        threw = true;
+    }
+    std::cout << "bad_alloc: " << threw << ", reserved: " << h.reserved() << ", published: " << h.published() << "\n";
+    return 0;
+}
@@ -0,0 +1,102 @@
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include "array.hpp"
+#include "vector.hpp"
+
+// CRC32 查找表（和 stb_image_write 里 stbiw__crc32 用的是同一张表）：编译期算好，直接放进 .rodata
+constexpr Array<uint32_t, 256> make_crc_table() {
+    Array<uint32_t, 256> t{};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; k++)
+            c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+        t[i] = c;
+    }
+    return t;
+}
+
+constexpr auto crc_table = make_crc_table();
+
+constexpr uint32_t crc32(std::string_view s) {
+    uint32_t c = ~0u;
+    for (unsigned char ch: s)
+        c = crc_table[(c ^ ch) & 0xff] ^ (c >> 8);
+    return ~c;
+}
+
+static_assert(crc_table[1] == 0x77073096);
+static_assert(crc32("123456789") == 0xcbf43926);
+
+// 结果个数事先不知道：在编译期用 Vector 攒出来，先求长度，再拷进同样长度的 Array
+constexpr Vector<int> make_primes(int limit) {
+    Vector<bool> composite(limit + 1, false);
+    Vector<int> primes;
+    for (int i = 2; i <= limit; i++) {
+        if (composite[i])
+            continue;
+        primes.push_back(i);
+        for (int j = i * i; j <= limit; j += i)
+            composite[j] = true;
+    }
+    return primes;
+}
+
+template <size_t N>
+constexpr Array<int, N> to_array(Vector<int> const &v) {
+    Array<int, N> a{};
+    for (size_t i = 0; i < N; i++)
+        a[i] = v[i];
+    return a;
+}
+
+constexpr size_t nprimes = make_primes(100).size();
+constexpr auto primes = to_array<nprimes>(make_primes(100));
+
+static_assert(nprimes == 25 && primes[24] == 97);
+
+// insert / erase 在常量求值时不能按字节搬，走逐个移动的路径
+constexpr bool edit_ok() {
+    Vector<int> v{1, 2, 3, 4, 5};
+    v.insert(v.begin() + 1, 3, 0);               // 1 0 0 0 2 3 4 5
+    v.insert(v.begin(), v.begin() + 4, v.end()); // 源区间在自己里面：2 3 4 5 1 0 0 0 2 3 4 5
+    v.erase(v.begin() + 2, v.begin() + 6);       // 2 3 0 0 2 3 4 5
+    v.resize(12, 7);
+    int const expected[] = {2, 3, 0, 0, 2, 3, 4, 5, 7, 7, 7, 7};
+    if (v.size() != std::size(expected))
+        return false;
+    for (size_t i = 0; i < v.size(); i++)
+        if (v[i] != expected[i])
+            return false;
+    return true;
+}
+
+static_assert(edit_ok());
+
+// 不可平凡搬迁的元素：扩容和插入都是逐个移动构造
+constexpr bool join_ok() {
+    Vector<std::string> v;
+    for (int i = 0; i < 10; i++)
+        v.emplace_back(i + 1, 'a' + i);
+    v.insert(v.begin() + 2, 2, "xy");
+    v.erase(v.begin());
+    std::string out;
+    for (auto const &x: v)
+        out += x;
+    return out.size() == 4 + 54 && out.substr(0, 6) == "bbxyxy";
+}
+
+static_assert(join_ok());
+
+int main() {
+    // 运行时走 memmove / realloc 的路径，结果要和编译期一样
+    std::cout << std::hex << crc32("123456789") << std::dec << "\n";
+    for (int p: primes)
+        std::cout << p << " ";
+    std::cout << "\n";
+    bool (*f)() = edit_ok;
+    std::cout << f() << "\n";
+    return 0;
+}
@@ -0,0 +1,63 @@
+#include <algorithm>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include "array.hpp"
+#include "vector.hpp"
+#include "parallel_algorithm.hpp"
+
+// 用很小的 grain 切出很多块，和 std 算法的结果逐个比较
+int main() {
+    WorkStealingPool pool(4);
+    std::mt19937 rng(42);
+    for (size_t n: {0, 1, 7, 1000, 12345}) {
+        Vector<int> v(n);
+        for (auto &x: v)
+            x = (int)(rng() % 1000) - 500;
+        std::vector<int> ref(v.begin(), v.end());
+        size_t grain = 64;
+
+        bool ok = true;
+        ok &= parallel_reduce(pool, v.begin(), v.end(), 0LL, std::plus<>(), grain)
+              == std::accumulate(ref.begin(), ref.end(), 0LL);
+        ok &= parallel_reduce(pool, v.begin(), v.end(), 1000, [](int a, int b) { return std::max(a, b); }, grain)
+              == std::max(1000, n ? *std::max_element(ref.begin(), ref.end()) : 1000);
+
+        Vector<int> s(n);
+        parallel_inclusive_scan(pool, v.begin(), v.end(), s.begin(), std::plus<>(), grain);
+        std::vector<int> rs(n);
+        std::inclusive_scan(ref.begin(), ref.end(), rs.begin());
+        ok &= std::equal(s.begin(), s.end(), rs.begin());
+
+        parallel_transform(pool, v.begin(), v.end(), s.begin(), [](int x) { return x * 3; }, grain);
+        parallel_for_each(pool, s.begin(), s.end(), [](int &x) { x += 1; }, grain);
+        for (size_t i = 0; i < n; i++)
+            ok &= s[i] == ref[i] * 3 + 1;
+
+        Vector<int> p = v;
+        auto mid = parallel_partition(pool, p.begin(), p.end(), [](int x) { return x % 3 == 0; }, grain);
+        std::vector<int> rp = ref;
+        auto rmid = std::stable_partition(rp.begin(), rp.end(), [](int x) { return x % 3 == 0; });
+        ok &= (size_t)(mid - p.begin()) == (size_t)(rmid - rp.begin()) && std::equal(p.begin(), p.end(), rp.begin());
+
+        parallel_sort(pool, v.begin(), v.end(), std::less<>(), grain);
+        std::sort(ref.begin(), ref.end());
+        ok &= std::equal(v.begin(), v.end(), ref.begin());
+        std::cout << "n = " << n << ": " << (ok ? "ok" : "FAILED") << "\n";
+    }
+
+    Array<double, 1000> arr;
+    for (size_t i = 0; i < arr.size(); i++)
+        arr[i] = (double)(i % 17);
+    parallel_sort(pool, arr.begin(), arr.end(), std::greater<>(), 100);
+    std::cout << "array: " << arr[0] << " " << arr[999] << " "
+              << parallel_reduce(pool, arr.begin(), arr.end(), 0.0, std::plus<>(), 100) << "\n";
+
+    Vector<std::string> words;
+    for (int i = 0; i < 300; i++)
+        words.push_back(std::to_string(i * 7919 % 1000));
+    parallel_sort(pool, words.begin(), words.end(), std::less<>(), 32);
+    std::cout << "strings sorted: " << std::is_sorted(words.begin(), words.end()) << "\n";
+    return 0;
+}
@@ -0,0 +1,61 @@
+#include <algorithm>
+#include <iostream>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+#include "segmented_vector.hpp"
+
+int main() {
+    SegmentedVector<int, 4> a;
+    int *first = &a.emplace_back(0);
+    for (int i = 1; i < 100; i++)
+        a.push_back(i);
+    // 扩容不搬家，最早拿到的地址仍然有效
+    std::cout << "stable: " << (first == &a[0]) << ", size: " << a.size()
+              << ", capacity: " << a.capacity() << "\n";
+    std::cout << "segment of 3, 4, 11, 12: " << a.segment_of(3) << " " << a.segment_of(4) << " "
+              << a.segment_of(11) << " " << a.segment_of(12) << "\n";
+    std::reverse(a.begin(), a.end());
+    std::cout << a[0] << " " << a[99] << " " << a.at(50) << "\n";
+    std::sort(a.begin(), a.end());
+    std::cout << std::is_sorted(a.begin(), a.end()) << "\n";
+
+    SegmentedVector<std::string> s;
+    for (int i = 0; i < 200; i++)
+        s.push_back(std::to_string(i));
+    s.pop_back();
+    auto t = std::move(s);
+    std::cout << t.size() << " " << t.back() << " " << s.size() << "\n";
+
+    // 4 个线程同时追加，每个元素都只出现一次
+    SegmentedVector<int> c;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++) {
+        threads.emplace_back([&c, t] {
+            for (int i = 0; i < 10000; i++)
+                c.concurrent_emplace_back(t * 10000 + i);
+        });
+    }
+    for (auto &th: threads)
+        th.join();
+    std::sort(c.begin(), c.end());
+    bool ok = c.size() == 40000;
+    for (int i = 0; ok && i < 40000; i++)
+        ok = c[i] == i;
+    std::cout << "concurrent: " << ok << "\n";
+
+    // 段分配失败时还没预定位置，size() 不变，析构不会去销毁没构造过的元素
+    struct Huge {
+        char bytes[size_t(1) << 40];
+    };
+    SegmentedVector<Huge> h;
+    bool threw = false;
+    try {
+        h.concurrent_emplace_back();
+    } catch (std::bad_alloc const &) {
+        threw = true;
+    }
+    std::cout << "bad_alloc: " << threw << ", size: " << h.size() << "\n";
+    return 0;
+}
@@ -0,0 +1,85 @@
+#include <iostream>
+#include <string>
+#include "small_vector.hpp"
+
+// 拷贝到第 budget 次时抛异常；live 记录活着的对象个数，用来查泄漏
+struct Flaky {
+    static inline int live = 0;
+    static inline int budget = -1;
+    int v;
+
+    Flaky(int v) : v(v) {
+        live++;
+    }
+    Flaky(Flaky const &o) : v(o.v) {
+        if (budget >= 0 && budget-- == 0)
+            throw std::runtime_error("copy failed");
+        live++;
+    }
+    Flaky(Flaky &&o) noexcept : v(o.v) {
+        live++;
+    }
+    Flaky &operator=(Flaky const &o) {
+        if (budget >= 0 && budget-- == 0)
+            throw std::runtime_error("copy failed");
+        v = o.v;
+        return *this;
+    }
+    Flaky &operator=(Flaky &&o) noexcept = default;
+    ~Flaky() {
+        live--;
+    }
+};
+
+int main() {
+    SmallVector<int, 4> a;
+    for (int i = 0; i < 4; i++)
+        a.push_back(i);
+    std::cout << "inline: " << a.is_inline() << "\n";
+    a.push_back(4);
+    std::cout << "after spill: " << a.is_inline() << "\n";
+    a.print();
+
+    // 插入自己的元素：扩容不能让源区间失效
+    a.insert(a.begin() + 1, a.begin(), a.end());
+    a.print();
+    a.erase(a.begin() + 1, a.begin() + 7);
+    a.shrink_to_fit();
+    std::cout << "back inline: " << a.is_inline() << "\n";
+    a.print();
+
+    SmallVector<std::string, 4> s{"a", "bb", "ccc"};
+    auto t = std::move(s); // 内部缓冲区里的元素只能逐个移动
+    std::cout << "moved-from size: " << s.size() << "\n";
+    t.insert(t.begin(), 3, "x");
+    t.print();
+    auto u = std::move(t); // 堆上的直接接管指针
+    std::cout << "heap moved: " << (t.size() == 0 && t.is_inline()) << "\n";
+    u.erase(u.begin());
+    u.print();
+    s.swap(u);
+    s.print();
+    u.assign({"p", "q"});
+    u.print();
+
+    // 插入一部分落在 size 之外、在那里拷贝构造时失败：构造出来的不能泄漏
+    bool clean = true;
+    for (int fail = 0; fail < 3; fail++) {
+        {
+            SmallVector<Flaky, 16> f;
+            for (int i = 0; i < 5; i++)
+                f.emplace_back(i);
+            Flaky val(9);
+            Flaky::budget = fail;
+            try {
+                f.insert(f.begin() + 3, 4, val);
+            } catch (std::runtime_error const &) {
+            }
+            Flaky::budget = -1;
+            clean = clean && Flaky::live == (int)f.size() + 1;
+        }
+        clean = clean && Flaky::live == 0;
+    }
+    std::cout << "insert throws cleanly: " << clean << "\n";
+    return 0;
+}
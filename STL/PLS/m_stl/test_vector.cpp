@@ -1,7 +1,57 @@
 #include <iostream>
+#include <string>
 #include <vector>
 #include "vector.hpp"
 
+// 拷贝到第 budget 次时抛异常；live 记录活着的对象个数，用来查泄漏
+struct Flaky {
+    static inline int live = 0;
+    static inline int budget = -1;
+    int v;
+
+    Flaky(int v) : v(v) {
+        live++;
+    }
+    Flaky(Flaky const &o) : v(o.v) {
+        if (budget >= 0 && budget-- == 0)
+            throw std::runtime_error("copy failed");
+        live++;
+    }
+    Flaky(Flaky &&o) noexcept : v(o.v) {
+        live++;
+    }
+    Flaky &operator=(Flaky const &o) {
+        if (budget >= 0 && budget-- == 0)
+            throw std::runtime_error("copy failed");
+        v = o.v;
+        return *this;
+    }
+    Flaky &operator=(Flaky &&o) noexcept = default;
+    ~Flaky() {
+        live--;
+    }
+};
+
+// 从 j 处插入 n 个，第 fail 次拷贝时失败：失败后活着的对象正好是容器里的加上 val
+static bool insert_throws_cleanly(size_t j, size_t n, int fail) {
+    {
+        Vector<Flaky> v;
+        v.reserve(16);
+        for (int i = 0; i < 5; i++)
+            v.emplace_back(i);
+        Flaky val(9);
+        Flaky::budget = fail;
+        try {
+            v.insert(v.begin() + j, n, val);
+        } catch (std::runtime_error const &) {
+        }
+        Flaky::budget = -1;
+        if (Flaky::live != (int)v.size() + 1)
+            return false;
+    }
+    return Flaky::live == 0;
+}
+
 int main() {
     Vector<int> arr;
     arr.push_back(1);
@@ -16,5 +66,27 @@ int main() {
     b.print();
     b.insert(b.end(), {1, 42, 2});
     b.print();
+    auto sq = Vector<int>::generate(5, [](size_t i) { return (int)(i * i); });
+    sq.print();
+    Vector<int> c(4, default_init);
+    int *p = c.reserve_uninitialized(2);
+    p[0] = 7;
+    p[1] = 8;
+    c.commit_uninitialized(2);
+    std::cout << c.size() << " " << c[4] << " " << c[5] << "\n";
+    // 插入自己的一段元素：插入前要先拷出来
+    b.insert(b.begin() + 1, b.begin(), b.begin() + 3);
+    b.print();
+    b.erase(b.begin() + 1, b.begin() + 4);
+    b.print();
+    Vector<std::string> s = {"a", "b", "c"};
+    s.insert(s.begin() + 1, 4, "x");
+    s.erase(s.begin());
+    s.print();
+    // 尾部比插入的多（逐个赋值时失败）和尾部比插入的少（在 size 之外构造时失败）两种情况
+    bool clean = true;
+    for (int fail = 0; fail < 3; fail++)
+        clean = clean && insert_throws_cleanly(1, 2, fail) && insert_throws_cleanly(3, 4, fail);
+    std::cout << "insert throws cleanly: " << clean << "\n";
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,142 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 常驻线程池：每个线程有自己的任务区间，自己从头部取，空闲时从别人的尾部偷
+// run() 不能嵌套调用，需要分阶段的算法（scan、sort）每个阶段各调一次；任务里不能抛异常
+struct WorkStealingPool {
+    explicit WorkStealingPool(unsigned nthreads = std::thread::hardware_concurrency())
+        : m_nthreads(nthreads ? nthreads : 1), m_queues(new Queue[m_nthreads]) {
+        for (unsigned t = 1; t < m_nthreads; t++)
+            m_threads.emplace_back([this, t] { worker(t); });
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard lck(m_mtx);
+            m_stop = true;
+        }
+        m_cv_start.notify_all();
+        for (auto &t: m_threads)
+            t.join();
+    }
+
+    WorkStealingPool(WorkStealingPool const &) = delete;
+    WorkStealingPool &operator=(WorkStealingPool const &) = delete;
+
+    unsigned size() const noexcept {
+        return m_nthreads;
+    }
+
+    // 执行 func(task, tid)，task 取遍 [0, ntasks)，tid 在 [0, size()) 内
+    // 调用线程自己作为 tid 0 参与计算，返回时所有任务都已完成
+    void run(size_t ntasks, std::function<void(size_t, unsigned)> const &func) {
+        if (ntasks == 0)
+            return;
+        if (m_nthreads == 1 || ntasks == 1) {
+            for (size_t i = 0; i < ntasks; i++)
+                func(i, 0);
+            return;
+        }
+        // 初始按连续区间平分，相邻任务留在同一线程上，对缓存友好
+        for (unsigned t = 0; t < m_nthreads; t++) {
+            std::lock_guard lck(m_queues[t].mtx);
+            m_queues[t].lo = ntasks * t / m_nthreads;
+            m_queues[t].hi = ntasks * (t + 1) / m_nthreads;
+        }
+        {
+            std::lock_guard lck(m_mtx);
+            m_func = &func;
+            m_running = m_nthreads - 1;
+            m_generation++;
+        }
+        m_cv_start.notify_all();
+        work(0);
+        std::unique_lock lck(m_mtx);
+        m_cv_done.wait(lck, [&] { return m_running == 0; });
+        m_func = nullptr;
+    }
+
+    // 把 [0, n) 切成大小为 grain 的块，执行 func(begin, end, tid)
+    template <class Func>
+    void parallel_for(size_t n, size_t grain, Func const &func) {
+        if (grain == 0)
+            grain = 1;
+        size_t nchunks = (n + grain - 1) / grain;
+        run(nchunks, [&](size_t c, unsigned tid) {
+            size_t begin = c * grain;
+            size_t end = begin + grain < n ? begin + grain : n;
+            func(begin, end, tid);
+        });
+    }
+
+private:
+    struct alignas(64) Queue {
+        std::mutex mtx;
+        size_t lo = 0, hi = 0;
+    };
+
+    bool pop(unsigned tid, size_t &task) {
+        auto &q = m_queues[tid];
+        std::lock_guard lck(q.mtx);
+        if (q.lo == q.hi)
+            return false;
+        task = q.lo++;
+        return true;
+    }
+
+    bool steal(unsigned tid, size_t &task) {
+        for (unsigned k = 1; k < m_nthreads; k++) {
+            auto &q = m_queues[(tid + k) % m_nthreads];
+            std::lock_guard lck(q.mtx);
+            if (q.lo != q.hi) {
+                task = --q.hi;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void work(unsigned tid) {
+        auto const &func = *m_func;
+        size_t task;
+        while (pop(tid, task) || steal(tid, task))
+            func(task, tid);
+    }
+
+    void worker(unsigned tid) {
+        size_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock lck(m_mtx);
+                m_cv_start.wait(lck, [&] { return m_stop || m_generation != seen; });
+                if (m_stop)
+                    return;
+                seen = m_generation;
+            }
+            work(tid);
+            {
+                std::lock_guard lck(m_mtx);
+                if (--m_running == 0)
+                    m_cv_done.notify_one();
+            }
+        }
+    }
+
+    unsigned m_nthreads;
+    std::unique_ptr<Queue[]> m_queues;
+    std::vector<std::thread> m_threads;
+    std::function<void(size_t, unsigned)> const *m_func = nullptr;
+
+    std::mutex m_mtx;
+    std::condition_variable m_cv_start;
+    std::condition_variable m_cv_done;
+    size_t m_generation = 0;
+    unsigned m_running = 0;
+    bool m_stop = false;
+};
@@ -1,286 +1,490 @@
 #pragma once
 #include <algorithm>
 #include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <initializer_list>
+#include <iostream>
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <new>
 #include <stdexcept>
 #include <utility>
+#include "allocator.hpp"
+#include "growth.hpp"
+
+// 标签：元素做默认初始化而不是值初始化，int / float 这类平凡类型不会被清零
+struct default_init_t {
+    explicit default_init_t() = default;
+};
+inline constexpr default_init_t default_init{};
+
+// std::uninitialized_* 在 C++20 里还不是 constexpr：常量求值时换成逐个 construct_at，运行时照旧调标准库
+namespace vector_detail {
+
+template <class It, class T>
+constexpr void uninit_copy_n(It first, size_t n, T *dst) {
+    if (std::is_constant_evaluated()) {
+        for (size_t i = 0; i < n; i++, ++first)
+            std::construct_at(dst + i, *first);
+    } else {
+        std::uninitialized_copy_n(first, n, dst);
+    }
+}
+
+template <class T>
+constexpr void uninit_move_n(T *src, size_t n, T *dst) {
+    uninit_copy_n(std::make_move_iterator(src), n, dst);
+}
 
 template <class T>
+constexpr void uninit_fill_n(T *dst, size_t n, T const &val) {
+    if (std::is_constant_evaluated()) {
+        for (size_t i = 0; i < n; i++)
+            std::construct_at(dst + i, val);
+    } else {
+        std::uninitialized_fill_n(dst, n, val);
+    }
+}
+
+template <class T>
+constexpr void uninit_value_construct_n(T *dst, size_t n) {
+    if (std::is_constant_evaluated()) {
+        for (size_t i = 0; i < n; i++)
+            std::construct_at(dst + i);
+    } else {
+        std::uninitialized_value_construct_n(dst, n);
+    }
+}
+
+// 在 data 里已构造的 old 个元素的 j 处腾出 n 个位置，逐个移动后用 get(k) 填进去，调用者成功后再把 size 改成 old + n
+// 移过去或直接构造在 old 之后的元素还不算在 size 里，中途抛异常时把它们销毁，[0, old) 仍然都是构造好的（可能是移走后的值）
+template <class T, class Get>
+constexpr void insert_shift(T *data, size_t old, size_t j, size_t n, Get &&get) {
+    size_t tail = old - j;
+    T *built = data + old; // [data + old, built) 已经构造
+    try {
+        if (tail >= n) {
+            // 最后 n 个搬到未构造的新位置上，其余的在已构造的位置之间后移
+            uninit_move_n(data + old - n, n, data + old);
+            built = data + old + n;
+            std::move_backward(data + j, data + old - n, data + old);
+            for (size_t k = 0; k < n; k++)
+                data[j + k] = get(k);
+        } else {
+            // 插入的一部分落在 old 之外，那部分直接构造，再把尾部接在它后面
+            for (size_t k = tail; k < n; k++, built++)
+                std::construct_at(built, get(k));
+            uninit_move_n(data + j, tail, data + j + n);
+            built = data + old + n;
+            for (size_t k = 0; k < tail; k++)
+                data[j + k] = get(k);
+        }
+    } catch (...) {
+        std::destroy(data + old, built);
+        throw;
+    }
+}
+
+} // namespace vector_detail
+
+// 元素的构造和析构直接在原地进行，不经过 allocator 的 construct / destroy
+// 除了 default_init 系列和 print，都可以在常量求值里用（C++20 的编译期 new / delete）：
+// constexpr 函数里可以用 Vector 攒出中间结果，但分配的内存必须在求值结束前释放，结果要拷进 Array 带出来
+template <class T, class Alloc = MallocAllocator<T>, class Growth = GrowDouble>
 struct Vector {
+    using value_type = T;
+    using allocator_type = Alloc;
+    using alloc_traits = std::allocator_traits<Alloc>;
+
     T *m_data;
     size_t m_size;
     size_t m_cap;
-    Vector() : m_data{nullptr}, m_size{0}, m_cap{0} {}
-    
-    explicit Vector(size_t n) {
-        m_data = new int[n]{};
+    [[no_unique_address]] Alloc m_alloc;
+
+    constexpr Vector() noexcept(noexcept(Alloc())) : m_data{nullptr}, m_size{0}, m_cap{0}, m_alloc() {}
+
+    constexpr explicit Vector(Alloc const &alloc) noexcept
+        : m_data{nullptr}, m_size{0}, m_cap{0}, m_alloc(alloc) {}
+
+    constexpr explicit Vector(size_t n, Alloc const &alloc = Alloc()) : Vector(alloc) {
+        reallocate(n);
+        vector_detail::uninit_value_construct_n(m_data, n);
         m_size = n;
-        m_cap = n;
     }
 
-    explicit Vector(size_t n, T val) {
-        m_data = new int[n];
-        for (size_t i = 0; i < n; i++) {
-            m_data[i] = val;
-        }
+    constexpr explicit Vector(size_t n, T const &val, Alloc const &alloc = Alloc()) : Vector(alloc) {
+        reallocate(n);
+        vector_detail::uninit_fill_n(m_data, n, val);
         m_size = n;
-        m_cap = n;
+    }
+
+    // 马上就要整个覆盖掉的缓冲区：不清零，省掉一整遍写内存
+    Vector(size_t n, default_init_t, Alloc const &alloc = Alloc()) : Vector(alloc) {
+        reallocate(n);
+        std::uninitialized_default_construct_n(m_data, n);
+        m_size = n;
+    }
+
+    // 第 i 个元素直接用 gen(i) 的返回值构造，每个元素只写一次
+    template <class Gen>
+    static constexpr Vector generate(size_t n, Gen &&gen, Alloc const &alloc = Alloc()) {
+        Vector v(alloc);
+        v.reallocate(n);
+        v.append_generate(n, gen);
+        return v;
     }
 
     template <std::random_access_iterator InputIt>
-    Vector(InputIt first, InputIt last) {
+    constexpr Vector(InputIt first, InputIt last, Alloc const &alloc = Alloc()) : Vector(alloc) {
         size_t n = last - first;
-        m_data = new int[n];
+        reallocate(n);
+        vector_detail::uninit_copy_n(first, n, m_data);
         m_size = n;
-        m_cap = n;
-        for (size_t i = 0; i < n; ++i) {
-            m_data[i] = *first;
-            ++first;
-        }
     }
 
-    Vector(std::initializer_list<T> list) : Vector(list.begin(), list.end()) {}
+    constexpr Vector(std::initializer_list<T> list, Alloc const &alloc = Alloc())
+        : Vector(list.begin(), list.end(), alloc) {}
 
-    void resize(size_t n, int val = 0) {
-        reserve(n);
+    constexpr void resize(size_t n) {
         if (n > m_size) {
-            for (size_t i = m_size; i < n; ++i) {
-                m_data[i] = val;
-            }
+            grow(n);
+            vector_detail::uninit_value_construct_n(m_data + m_size, n - m_size);
+            m_size = n;
+        } else {
+            destroy_tail(n);
         }
-        m_size = n;
     }
 
-    void reserve(size_t n) {
-        if (n <= m_cap) [[likely]]
-            return;
-        n = std::max(n, m_cap * 2);
-        auto old_data = m_data;
-        if (n == 0) {
-            m_data = nullptr;
-            m_cap = 0;
-            if (old_data) delete[] old_data;
+    constexpr void resize(size_t n, T const &val) {
+        if (n > m_size) {
+            grow(n);
+            vector_detail::uninit_fill_n(m_data + m_size, n - m_size, val);
+            m_size = n;
         } else {
-            m_data = new int[n];
-            m_cap = n;
-            if (old_data) {
-                memcpy(m_data, old_data, m_size * sizeof(T));
-                delete[] old_data;
-            }
+            destroy_tail(n);
         }
     }
 
-    void shirk_to_fit() {
-        auto old_data = m_data;
-        m_cap = m_size;
-        if (m_size == 0) {
-            m_data = nullptr;
+    // 新增的元素做默认初始化，平凡类型的内容是未定义的，调用者负责随后写入
+    void resize_default_init(size_t n) {
+        if (n > m_size) {
+            grow(n);
+            std::uninitialized_default_construct(m_data + m_size, m_data + n);
+            m_size = n;
         } else {
-            m_data = new int[m_size];
+            destroy_tail(n);
         }
-        if (old_data) {
-            if (m_size != 0)
-                memcpy(m_data, old_data, m_size * sizeof(T));
-            delete[] old_data;
+    }
+
+    // 在末尾追加 n 个元素，第 k 个用 gen(size() + k) 构造；gen 抛异常时已经构造的保留
+    template <class Gen>
+    constexpr void append_generate(size_t n, Gen &&gen) {
+        grow(m_size + n);
+        size_t end = m_size + n;
+        for (size_t i = m_size; i < end; i++) {
+            std::construct_at(m_data + i, gen(i));
+            m_size = i + 1;
         }
     }
 
-    void clear() {
-        resize(0);
+    // 精确分配 n 个，不经过增长策略
+    constexpr void reserve(size_t n) {
+        if (n <= m_cap) [[likely]]
+            return;
+        reallocate(n);
+    }
+
+    // 保证末尾至少还有 n 个空位并返回第一个空位的地址；写完之后用 commit_uninitialized(k) 把前 k 个算进 size
+    // 只用于隐式生存期类型（平凡类型），它们不需要构造就能直接写
+    T *reserve_uninitialized(size_t n) {
+        static_assert(std::is_trivially_default_constructible_v<T> && std::is_trivially_destructible_v<T>,
+                      "reserve_uninitialized needs a trivial element type");
+        grow(m_size + n);
+        return m_data + m_size;
     }
 
-    size_t size() const noexcept {
+    void commit_uninitialized(size_t k) noexcept {
+        m_size += k;
+    }
+
+    constexpr void shrink_to_fit() {
+        if (m_cap != m_size)
+            reallocate(m_size);
+    }
+
+    void shirk_to_fit() {
+        shrink_to_fit();
+    }
+
+    constexpr void clear() noexcept {
+        destroy_tail(0);
+    }
+
+    constexpr size_t size() const noexcept {
         return m_size;
     }
 
-    size_t capacity() const noexcept {
+    constexpr size_t capacity() const noexcept {
         return m_cap;
     }
 
-    Vector(Vector const &other) {
-        m_size = other.m_size;
-        if (m_size != 0) {
-            m_data = new int[m_size];
-            std::copy(other.m_data, other.m_data + other.m_size, m_data);
-        } else {
-            m_data = nullptr;
-        }
+    constexpr bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    constexpr T *data() noexcept {
+        return m_data;
+    }
+
+    constexpr T const *data() const noexcept {
+        return m_data;
+    }
+
+    constexpr Alloc get_allocator() const noexcept {
+        return m_alloc;
     }
 
-    Vector &operator=(Vector const &other) {
+    constexpr Vector(Vector const &other)
+        : Vector(other.begin(), other.end(),
+                 alloc_traits::select_on_container_copy_construction(other.m_alloc)) {}
+
+    constexpr Vector(Vector const &other, Alloc const &alloc) : Vector(other.begin(), other.end(), alloc) {}
+
+    constexpr Vector &operator=(Vector const &other) {
         if (this == &other) {
             return *this;
         }
-        reserve(other.m_size);
-        m_size = other.m_size;
-        for (size_t i = 0; i != m_size; ++i) {
-            m_data[i] = other.m_data[i];
+        if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+            if (m_alloc != other.m_alloc) {
+                // 旧内存必须用旧的分配器还回去
+                clear();
+                reallocate(0);
+            }
+            m_alloc = other.m_alloc;
         }
+        assign(other.begin(), other.end());
         return *this;
     }
 
     template <std::random_access_iterator InputIt>
-    void assign(InputIt first, InputIt last) {
+    constexpr void assign(InputIt first, InputIt last) {
         size_t n = last - first;
-        reserve(n);
-        m_size = n;
-        for (size_t i = 0; i < n; ++i) {
-            m_data[i] = *first;
-            ++first;
+        if (n > m_cap) {
+            clear();
+            reallocate(0);
+            reallocate(n);
         }
+        size_t common = std::min(n, m_size);
+        std::copy(first, first + common, m_data);
+        vector_detail::uninit_copy_n(first + common, n - common, m_data + common);
+        destroy_tail(common);
+        m_size = n;
     }
 
-    void assign(size_t n, T val) {
-        reserve(n);
-        m_size = n;
-        for (size_t i = 0; i < n; ++i) {
-            m_data[i] = val;
+    constexpr void assign(size_t n, T const &val) {
+        if (n > m_cap) {
+            clear();
+            reallocate(0);
+            reallocate(n);
         }
+        size_t common = std::min(n, m_size);
+        std::fill_n(m_data, common, val);
+        vector_detail::uninit_fill_n(m_data + common, n - common, val);
+        destroy_tail(common);
+        m_size = n;
     }
-    void assign(std::initializer_list<T> list) {
+
+    constexpr void assign(std::initializer_list<T> list) {
         assign(list.begin(), list.end());
     }
 
-    Vector(Vector &&other) noexcept : m_size(other.m_size), m_data(other.m_data) {
+    constexpr Vector(Vector &&other) noexcept
+        : m_data(other.m_data), m_size(other.m_size), m_cap(other.m_cap),
+          m_alloc(std::move(other.m_alloc)) {
         other.m_data = nullptr;
         other.m_size = 0;
+        other.m_cap = 0;
     }
 
-    Vector &operator=(Vector &&other) noexcept {
-        m_data = other.m_data;
-        m_size = other.m_size;
-        other.m_data = nullptr;
-        other.m_size = 0;
+    constexpr Vector(Vector &&other, Alloc const &alloc) : Vector(alloc) {
+        if (m_alloc == other.m_alloc) {
+            steal(other);
+        } else {
+            reallocate(other.m_size);
+            vector_detail::uninit_move_n(other.m_data, other.m_size, m_data);
+            m_size = other.m_size;
+        }
+    }
+
+    // 分配器不随移动传播且两边不相等时，内存不能接管，只能逐个移动元素
+    constexpr Vector &operator=(Vector &&other) noexcept(
+            alloc_traits::propagate_on_container_move_assignment::value ||
+            alloc_traits::is_always_equal::value) {
+        if (this == &other) {
+            return *this;
+        }
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+            clear();
+            reallocate(0);
+            m_alloc = std::move(other.m_alloc);
+            steal(other);
+        } else {
+            if (m_alloc == other.m_alloc) {
+                clear();
+                reallocate(0);
+                steal(other);
+            } else {
+                assign(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+                other.clear();
+            }
+        }
         return *this;
     }
 
-    T const &operator[](size_t i) const noexcept {
+    constexpr void swap(Vector &other) noexcept {
+        using std::swap;
+        if constexpr (alloc_traits::propagate_on_container_swap::value)
+            swap(m_alloc, other.m_alloc);
+        swap(m_data, other.m_data);
+        swap(m_size, other.m_size);
+        swap(m_cap, other.m_cap);
+    }
+
+    friend constexpr void swap(Vector &a, Vector &b) noexcept {
+        a.swap(b);
+    }
+
+    constexpr T const &operator[](size_t i) const noexcept {
         return m_data[i];
     }
 
-    T &operator[](size_t i) noexcept {
+    constexpr T &operator[](size_t i) noexcept {
         return m_data[i];
     }
 
-    T const &at(size_t i) const {
+    constexpr T const &at(size_t i) const {
         if (i >= m_size) [[unlikely]]
             throw std::out_of_range("vector::at");
         return m_data[i];
     }
 
-    T &at(size_t i) {
+    constexpr T &at(size_t i) {
         if (i >= m_size) [[unlikely]]
             throw std::out_of_range("vector::at");
         return m_data[i];
     }
 
-    int const &front() const noexcept {
+    constexpr T const &front() const noexcept {
         return operator[](0);
     }
 
-    T &front() noexcept {
+    constexpr T &front() noexcept {
         return operator[](0);
     }
 
-    int const &back() const noexcept {
+    constexpr T const &back() const noexcept {
         return operator[](size() - 1);
     }
 
-    T &back() noexcept {
+    constexpr T &back() noexcept {
         return operator[](size() - 1);
     }
 
-    void push_back(T val) {
-        reserve(size() + 1);
-        m_size = m_size + 1;
-        back() = val;
+    constexpr void push_back(T const &val) {
+        emplace_back(val);
+    }
+
+    constexpr void push_back(T &&val) {
+        emplace_back(std::move(val));
+    }
+
+    template <class ...Args>
+    constexpr T &emplace_back(Args &&...args) {
+        if (m_size == m_cap) [[unlikely]] {
+            // args 可能引用着自己的元素，先构造出来再扩容
+            T tmp(std::forward<Args>(args)...);
+            grow(m_size + 1);
+            std::construct_at(m_data + m_size, std::move(tmp));
+        } else {
+            std::construct_at(m_data + m_size, std::forward<Args>(args)...);
+        }
+        return m_data[m_size++];
     }
 
-    T *begin() {
+    constexpr void pop_back() noexcept {
+        destroy_tail(m_size - 1);
+    }
+
+    constexpr T *begin() {
         return m_data;
     }
 
-    T *end() {
+    constexpr T *end() {
         return m_data + m_size;
     }
 
-    int const *begin() const {
+    constexpr T const *begin() const {
         return m_data;
     }
 
-    int const *end() const {
+    constexpr T const *end() const {
         return m_data + m_size;
     }
 
 
-    void erase(size_t i) {
-        for (size_t j = i + 1; j < m_size; ++j) {
-            m_data[j - 1] = std::move(m_data[j]);
-        }
-        resize(m_size - 1);
+    constexpr void erase(size_t i) {
+        erase(i, i + 1);
     }
 
-    void erase(size_t ibeg, size_t iend) {
+    constexpr void erase(size_t ibeg, size_t iend) {
         size_t diff = iend - ibeg;
-        for (size_t j = iend; j < m_size; j++) {
-            m_data[j - diff] = std::move(m_data[j]);
+        if (diff == 0) [[unlikely]]
+            return;
+        if constexpr (is_trivially_relocatable_v<T>) {
+            // 先析构被删的，再把后面的整段按字节挪过来；常量求值时不能 memmove，走下面的逐个移动
+            if (!std::is_constant_evaluated()) {
+                std::destroy(m_data + ibeg, m_data + iend);
+                relocate(m_data + iend, m_size - iend, m_data + ibeg);
+                m_size -= diff;
+                return;
+            }
         }
-        resize(m_size - diff);
+        std::move(m_data + iend, m_data + m_size, m_data + ibeg);
+        destroy_tail(m_size - diff);
     }
-    
-    void erase(T const *it) {
-        size_t i = it - m_data;
-        for (size_t j = i + 1; j < m_size; ++j) {
-            m_data[j - 1] = std::move(m_data[j]);
-        }
-        resize(m_size - 1);
+
+    constexpr void erase(T const *it) {
+        erase(it - m_data);
     }
 
-    void erase(T const *first, T const *last) {
-        size_t ibeg = first - m_data;
-        size_t iend = last - m_data;
-        size_t diff = iend - ibeg;
-        for (size_t j = iend; j < m_size; j++) {
-            m_data[j - diff] = std::move(m_data[j]);
-        }
-        resize(m_size - diff);
+    constexpr void erase(T const *first, T const *last) {
+        erase(first - m_data, last - m_data);
     }
 
-    void insert(T const *it, size_t n, T val) {
-        size_t j = it - m_data;
-        if (n == 0) [[unlikely]]
-            return;
-        reserve(n + m_size);
-        m_size += n;
-        for (size_t i = n; i > 0; --i) {
-            m_data[j + n + i - 1] = std::move(m_data[j + i - 1]);
-        }
-        for (size_t i = j; i < j + n; ++i) {
-            m_data[i] = val;
-        }
+    constexpr void insert(T const *it, size_t n, T val) {
+        // val 是按值传进来的，引用自己的元素也没关系
+        insert_n(it - m_data, n, [&](T *dst, size_t k) {
+            vector_detail::uninit_fill_n(dst, k, val);
+        }, [&](size_t) -> T const & { return val; });
     }
-    
+
     template <std::random_access_iterator InputIt>
-    void insert(T const *it, InputIt first, InputIt last) {
-        size_t n = last - first;
-        size_t j = it - m_data;
-        if (n == 0) [[unlikely]]
-            return;
-        reserve(n + m_size);
-        m_size += n;
-        for (size_t i = n; i > 0; --i) {
-            m_data[j + n + i - 1] = std::move(m_data[j + i - 1]);
-        }
-        for (size_t i = j; i < j + n; ++i) {
-            m_data[i] = *first;
-            ++first;
+    constexpr void insert(T const *it, InputIt first, InputIt last) {
+        if constexpr (std::is_pointer_v<InputIt>) {
+            // 源区间在自己里面时，扩容和挪动都会让它失效，先拷出来，再直接从 tmp 的缓冲区插入
+            if (owns(first)) {
+                Vector tmp(first, last, m_alloc);
+                insert_copy(it - m_data, tmp.data(), tmp.size());
+                return;
+            }
         }
+        insert_copy(it - m_data, first, last - first);
     }
-    
-    void insert(T const *it, std::initializer_list<T> list) {
+
+    constexpr void insert(T const *it, std::initializer_list<T> list) {
         insert(it, list.begin(), list.end());
     }
 
@@ -291,7 +495,122 @@ struct Vector {
         std::cout << "\n";
     }
 
-    ~Vector() {
-        delete[] m_data;
+    constexpr ~Vector() {
+        clear();
+        reallocate(0);
+    }
+
+private:
+    // 分配器提供 reallocate 时，可平凡搬迁的元素直接按字节扩容
+    static constexpr bool use_realloc = is_trivially_relocatable_v<T> && Reallocatable<Alloc>;
+
+    constexpr void steal(Vector &other) noexcept {
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_cap = std::exchange(other.m_cap, 0);
+    }
+
+    // 按增长策略扩到至少 need 个
+    constexpr void grow(size_t need) {
+        if (need <= m_cap) [[likely]]
+            return;
+        reallocate(Growth::next(m_cap, need, sizeof(T)));
+    }
+
+    // 把容量改成恰好 n 个（n >= m_size）
+    constexpr void reallocate(size_t n) {
+        if (n == 0) {
+            if (m_data)
+                alloc_traits::deallocate(m_alloc, m_data, m_cap);
+            m_data = nullptr;
+            m_cap = 0;
+            return;
+        }
+        if constexpr (use_realloc) {
+            // MallocAllocator 的大块在 glibc 里是 mmap 出来的，realloc 会用 mremap 原地扩展，不拷贝数据
+            // 常量求值时没有 realloc，走下面分配新块再逐个搬的路径
+            if (!std::is_constant_evaluated()) {
+                m_data = m_data ? m_alloc.reallocate(m_data, m_cap, n) : alloc_traits::allocate(m_alloc, n);
+                m_cap = n;
+                return;
+            }
+        }
+        // 移动构造不会抛异常时才移动，否则拷贝，保证失败时原来的内容不变
+        T *p = alloc_traits::allocate(m_alloc, n);
+        T *src = m_data;
+        if constexpr (std::is_nothrow_move_constructible_v<T> || !std::is_copy_constructible_v<T>) {
+            vector_detail::uninit_move_n(src, m_size, p);
+        } else {
+            try {
+                vector_detail::uninit_copy_n(src, m_size, p);
+            } catch (...) {
+                alloc_traits::deallocate(m_alloc, p, n);
+                throw;
+            }
+        }
+        std::destroy(src, src + m_size);
+        if (src)
+            alloc_traits::deallocate(m_alloc, src, m_cap);
+        m_data = p;
+        m_cap = n;
+    }
+
+    // p 是否指向自己的某个元素；常量求值时不同对象的指针不能比大小，只能逐个比较相等
+    // 运行时直接比指针而不用 std::less：p 从 m_data 算出来时 GCC 能把判断折叠掉，
+    // 否则它会以为 realloc 之后还在读旧指针，报 -Wuse-after-free
+    constexpr bool owns(T const *p) const noexcept {
+        if (std::is_constant_evaluated()) {
+            for (size_t i = 0; i < m_size; i++)
+                if (m_data + i == p)
+                    return true;
+            return false;
+        }
+        return m_data <= p && p < m_data + m_size;
+    }
+
+    // 把 src 处的 n 个元素按字节搬到 dst，搬完 src 处算作未构造；两段可以重叠
+    static void relocate(T *src, size_t n, T *dst) noexcept {
+        if (n)
+            std::memmove((void *)dst, (void const *)src, n * sizeof(T));
+    }
+
+    // 在 j 处插入 first 开始的 n 个元素的拷贝，源区间不能在自己里面
+    template <class InputIt>
+    constexpr void insert_copy(size_t j, InputIt first, size_t n) {
+        insert_n(j, n, [&](T *dst, size_t k) {
+            vector_detail::uninit_copy_n(first, k, dst);
+        }, [&](size_t k) -> decltype(auto) { return first[k]; });
+    }
+
+    // 在 j 处插入 n 个元素：construct(dst, k) 在未构造的 dst 上构造前 k 个，get(k) 给出第 k 个
+    // 可平凡搬迁时尾部整段 memmove 出一个空洞，直接在里面批量构造；否则逐个移动再赋值
+    template <class Construct, class Get>
+    constexpr void insert_n(size_t j, size_t n, Construct construct, Get get) {
+        if (n == 0) [[unlikely]]
+            return;
+        grow(m_size + n);
+        size_t old = m_size;
+        if constexpr (is_trivially_relocatable_v<T>) {
+            if (!std::is_constant_evaluated()) {
+                size_t tail = old - j;
+                relocate(m_data + j, tail, m_data + j + n);
+                try {
+                    construct(m_data + j, n);
+                } catch (...) {
+                    // 构造失败时把尾部挪回去，容器保持原样
+                    relocate(m_data + j + n, tail, m_data + j);
+                    throw;
+                }
+                m_size = old + n;
+                return;
+            }
+        }
+        vector_detail::insert_shift(m_data, old, j, n, get);
+        m_size = old + n;
+    }
+
+    constexpr void destroy_tail(size_t n) noexcept {
+        std::destroy(m_data + n, m_data + m_size);
+        m_size = n;
     }
-};
\ No newline at end of file
+};